@@ -0,0 +1,387 @@
+#!/usr/bin/env python3
+"""Sweep stress_job.py over a grid of workloads and write a comparable report.
+
+Each configuration runs in its own process. Results are collected into
+results.csv and results.json inside a report directory, along with a
+provenance record. Nothing is downloaded or installed. The harness runs
+against whichever phylotrackpy the current interpreter imports.
+
+    python3 stress_batch.py                    # quick grid
+    python3 stress_batch.py --grid full        # population sizes up to 10^6
+    python3 stress_batch.py --only mode=steady-state --only pop_size=1000
+    python3 stress_batch.py --compare old/results.csv
+    python3 stress_batch.py --grid collapse --seconds 120 --generations 100000
+
+Each workload is also run once without a systematics manager. The retained
+memory of that control run is subtracted before dividing by the number of
+stored taxa, giving "tracking bytes per retained taxon". That figure still
+includes allocator slack, so --compare only fails on large changes to it.
+
+With --compare, each configuration is checked against a previous report.
+Generations per second and snapshot size may change by --tolerance, peak RSS
+by --memory-tolerance, and tracking bytes per retained taxon by
+--per-taxon-tolerance. The exit status is nonzero if any of them regressed
+by more than that.
+"""
+import argparse
+import csv
+import datetime
+import itertools as it
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+GRIDS = {
+    "quick": {
+        "pop_size": [10, 1000, 10000],
+        "mutation_rate": [0.01, 0.2],
+        "mode": ["synchronous", "steady-state"],
+        "position": [False, True],
+        "prune": ["prune", "archive", "window"],
+        "collapse": ["off", "eager", "lazy"],
+    },
+    "full": {
+        "pop_size": [10, 100, 1000, 10000, 100000, 1000000],
+        "mutation_rate": [0.001, 0.01, 0.2, 1.0],
+        "mode": ["synchronous", "steady-state"],
+        "position": [False, True],
+        "prune": ["prune", "archive", "window"],
+        "collapse": ["off", "eager", "lazy"],
+    },
+    # Long neutral runs where unifurcation collapse dominates after add/remove.
+    # Eager collapse can't be combined with archiving, so only pruned runs.
+    "collapse": {
+        "pop_size": [100, 1000, 10000],
+        "mutation_rate": [0.01, 0.2, 1.0],
+        "mode": ["synchronous", "steady-state"],
+        "position": [False],
+        "prune": ["prune"],
+        "collapse": ["eager", "lazy"],
+    },
+}
+
+FIELDS = [
+    "job", "status", "population size", "mutation rate", "mode",
+    "position tracking", "pruning", "window", "collapse unifurcations",
+    "replicate", "seed", "generations", "seconds", "generations per second",
+    "births per second", "peak rss (bytes)", "retained rss (bytes)", "taxa",
+    "active taxa", "ancestor taxa", "outside taxa",
+    "bytes per retained taxon", "control retained rss (bytes)",
+    "tracking bytes per retained taxon", "snapshot size (bytes)",
+    "snapshot seconds",
+]
+
+CONFIG_FIELDS = [
+    "population size", "mutation rate", "mode", "position tracking",
+    "pruning", "collapse unifurcations",
+]
+
+# metric, whether bigger is better, and the argument holding its tolerance.
+# Peak RSS is stable from run to run; the per-taxon figure is a difference of
+# two RSS readings, so it only catches gross regressions.
+COMPARED = [
+    ("generations per second", True, "tolerance"),
+    ("snapshot size (bytes)", False, "tolerance"),
+    ("peak rss (bytes)", False, "memory_tolerance"),
+    ("tracking bytes per retained taxon", False, "per_taxon_tolerance"),
+]
+
+
+def parse_args(argv=None):
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="\n".join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument("--grid", choices=sorted(GRIDS), default="quick")
+    parser.add_argument(
+        "--only", action="append", default=[], metavar="KEY=VALUE",
+        help="restrict a grid axis to one or more comma separated values",
+    )
+    parser.add_argument("--replicates", type=int, default=1)
+    parser.add_argument("--generations", type=int, default=1000)
+    parser.add_argument("--seconds", type=float, default=30.0,
+                        help="wall time limit for each job's evolution loop")
+    parser.add_argument("--window", type=int, default=100)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--timeout", type=float, default=None,
+                        help="kill a job after this many seconds")
+    parser.add_argument("--outdir", default=None)
+    parser.add_argument("--compare", default=None, metavar="RESULTS_CSV")
+    parser.add_argument("--tolerance", type=float, default=0.2,
+                        help="relative change in speed and snapshot size "
+                        "tolerated by --compare")
+    parser.add_argument("--memory-tolerance", type=float, default=0.3,
+                        help="relative change in peak RSS tolerated by "
+                        "--compare")
+    parser.add_argument("--per-taxon-tolerance", type=float, default=1.0,
+                        help="relative change in tracking bytes per retained "
+                        "taxon tolerated by --compare")
+    return parser.parse_args(argv)
+
+
+def parse_value(axis, value):
+    if axis == "pop_size":
+        return int(float(value))
+    if axis == "mutation_rate":
+        return float(value)
+    if axis == "position":
+        return value.lower() in ("1", "true", "yes", "on")
+    return value
+
+
+def build_grid(args):
+    grid = dict(GRIDS[args.grid])
+    for restriction in args.only:
+        axis, _, values = restriction.partition("=")
+        axis = axis.replace("-", "_")
+        if axis not in grid:
+            sys.exit(f"unknown grid axis {axis!r}, expected one of {sorted(grid)}")
+        grid[axis] = [parse_value(axis, v) for v in values.split(",")]
+    axes = sorted(grid)
+    for values in it.product(*(grid[axis] for axis in axes)):
+        yield dict(zip(axes, values))
+
+
+def control_point(point):
+    """The same workload as `point`, but with only the settings that affect the Python side."""
+    return {**point, "position": False, "prune": "prune", "collapse": "off"}
+
+
+def job_command(point, replicate, args, tracking=True):
+    command = [
+        sys.executable, os.path.join(HERE, "stress_job.py"),
+        "--pop-size", str(point["pop_size"]),
+        "--mutation-rate", repr(point["mutation_rate"]),
+        "--mode", point["mode"],
+        "--prune", point["prune"],
+        "--window", str(args.window),
+        "--generations", str(args.generations),
+        "--seconds", str(args.seconds),
+        "--seed", str(args.seed),
+        "--replicate", str(replicate),
+    ]
+    if point["position"]:
+        command.append("--position")
+    command += ["--collapse", point["collapse"]]
+    if not tracking:
+        command.append("--no-tracking")
+    return command
+
+
+def run_job(command, args):
+    try:
+        proc = subprocess.run(
+            command, capture_output=True, text=True, timeout=args.timeout,
+        )
+    except subprocess.TimeoutExpired:
+        return {"status": "timeout"}
+    if proc.returncode != 0:
+        error = proc.stderr.strip().splitlines()
+        return {"status": f"error: {error[-1] if error else proc.returncode}"}
+    return json.loads(proc.stdout.strip().splitlines()[-1])
+
+
+def provenance(args):
+    try:
+        revision = subprocess.run(
+            ["git", "rev-parse", "HEAD"], cwd=HERE,
+            capture_output=True, text=True,
+        ).stdout.strip() or None
+    except OSError:
+        revision = None
+    try:
+        import phylotrackpy
+        module = os.path.dirname(os.path.abspath(phylotrackpy.__file__))
+    except ImportError:
+        module = None
+    return {
+        "date": datetime.datetime.now().astimezone().isoformat(),
+        "revision": revision,
+        "phylotrackpy": module,
+        "python": sys.version,
+        "platform": platform.platform(),
+        "machine": platform.machine(),
+        "processor": platform.processor(),
+        "cpu count": os.cpu_count(),
+        "arguments": vars(args),
+    }
+
+
+def config_key(row):
+    return tuple(str(row.get(field)) for field in CONFIG_FIELDS)
+
+
+def read_results(path):
+    with open(path, newline="") as results:
+        return list(csv.DictReader(results))
+
+
+def median_by_config(rows, metric):
+    values = {}
+    for row in rows:
+        value = row.get(metric)
+        if row.get("status") != "ok" or value in (None, ""):
+            continue
+        values.setdefault(config_key(row), []).append(float(value))
+    return {key: statistics.median(v) for key, v in values.items()}
+
+
+def compare(old_rows, new_rows, args):
+    """Print per-configuration ratios and return the number of regressions."""
+    regressions = 0
+    for metric, higher_is_better, tolerance_arg in COMPARED:
+        tolerance = getattr(args, tolerance_arg)
+        old = median_by_config(old_rows, metric)
+        new = median_by_config(new_rows, metric)
+        for key in sorted(old.keys() & new.keys()):
+            if not old[key] or old[key] < 0:
+                continue
+            ratio = new[key] / old[key]
+            change = ratio - 1 if higher_is_better else 1 - ratio
+            regressed = change < -tolerance
+            regressions += regressed
+            print(
+                f"{'REGRESSION' if regressed else 'ok':>10} "
+                f"{metric:>33} x{ratio:6.2f}  "
+                + " ".join(f"{f}={v}" for f, v in zip(CONFIG_FIELDS, key))
+            )
+    return regressions
+
+
+def collapse_summary(rows):
+    """Pair up runs that differ only in how unifurcations are collapsed.
+
+    Returns one row per configuration with throughput and memory ratios of
+    lazy collapse over eager collapse.
+    """
+    by_config = {}
+    for row in rows:
+        if row.get("status") != "ok":
+            continue
+        key = tuple(
+            str(row.get(f)) for f in CONFIG_FIELDS if f != "collapse unifurcations"
+        )
+        collapse = row.get("collapse unifurcations")
+        by_config.setdefault(key, {}).setdefault(collapse, []).append(row)
+
+    summary = []
+    for key, runs in sorted(by_config.items()):
+        if "eager" not in runs or "lazy" not in runs:
+            continue
+        entry = dict(zip(
+            (f for f in CONFIG_FIELDS if f != "collapse unifurcations"), key,
+        ))
+        for metric in ("generations per second", "taxa",
+                       "tracking bytes per retained taxon",
+                       "snapshot size (bytes)"):
+            eager, lazy = (
+                statistics.median(
+                    [float(r[metric]) for r in runs[collapse]
+                     if r.get(metric) not in (None, "")] or [float("nan")]
+                )
+                for collapse in ("eager", "lazy")
+            )
+            entry[f"{metric} (eager)"] = eager
+            entry[f"{metric} (lazy)"] = lazy
+            entry[f"{metric} ratio"] = lazy / eager if eager else None
+        summary.append(entry)
+    return summary
+
+
+def add_control(result, point, replicate, controls, args):
+    """Fills in memory figures relative to a run of the same workload without tracking."""
+    if result.get("status") != "ok" or not result.get("taxa"):
+        return
+    key = (replicate, tuple(sorted(control_point(point).items())))
+    if key not in controls:
+        command = job_command(control_point(point), replicate, args, tracking=False)
+        controls[key] = run_job(command, args)
+    control = controls[key]
+    if control.get("status") != "ok":
+        return
+    result["control retained rss (bytes)"] = control["retained rss (bytes)"]
+    result["tracking bytes per retained taxon"] = (
+        result["retained rss (bytes)"] - control["retained rss (bytes)"]
+    ) / result["taxa"]
+
+
+def main(argv=None):
+    args = parse_args(argv)
+    stamp = datetime.datetime.now().strftime("%Y-%m-%dT%H-%M-%S")
+    outdir = args.outdir or os.path.join(HERE, f"stress={stamp}")
+    os.makedirs(outdir, exist_ok=True)
+
+    with open(os.path.join(outdir, "provenance.json"), "w") as out:
+        json.dump(provenance(args), out, indent=2)
+
+    points = list(build_grid(args))
+    controls = {}
+    rows = []
+    csv_path = os.path.join(outdir, "results.csv")
+    with open(csv_path, "w", newline="") as out:
+        writer = csv.DictWriter(out, fieldnames=FIELDS, extrasaction="ignore")
+        writer.writeheader()
+        for replicate, (i, point) in it.product(
+            range(args.replicates), enumerate(points),
+        ):
+            command = job_command(point, replicate, args)
+            result = run_job(command, args)
+            if "job" not in result:
+                # The job died before it could describe itself
+                result.update({
+                    "population size": point["pop_size"],
+                    "mutation rate": point["mutation_rate"],
+                    "mode": point["mode"],
+                    "position tracking": point["position"],
+                    "pruning": point["prune"],
+                    "collapse unifurcations": point["collapse"],
+                    "replicate": replicate,
+                })
+            add_control(result, point, replicate, controls, args)
+            rows.append(result)
+            writer.writerow(result)
+            out.flush()
+            print(
+                f"[{len(rows)}/{len(points) * args.replicates}] "
+                f"{result.get('job', point)} {result['status']} "
+                f"{result.get('generations per second') or 0:.2f} gen/s",
+                flush=True,
+            )
+
+    with open(os.path.join(outdir, "results.json"), "w") as out:
+        json.dump(rows, out, indent=2)
+
+    summary = collapse_summary(read_results(csv_path))
+    if summary:
+        with open(os.path.join(outdir, "collapse.csv"), "w", newline="") as out:
+            writer = csv.DictWriter(out, fieldnames=list(summary[0]))
+            writer.writeheader()
+            writer.writerows(summary)
+        for entry in summary:
+            print(
+                f"lazy/eager x{entry['generations per second ratio'] or 0:5.2f} gen/s "
+                f"x{entry['taxa ratio'] or 0:5.2f} taxa  "
+                + " ".join(
+                    f"{f}={entry[f]}" for f in CONFIG_FIELDS if f in entry
+                )
+            )
+    print(f"report written to {outdir}")
+
+    if args.compare:
+        # Round trip through csv so both sides are compared as the same types
+        regressions = compare(read_results(args.compare), read_results(csv_path),
+                              args)
+        print(f"{regressions} regression(s) beyond tolerance")
+        return 1 if regressions else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
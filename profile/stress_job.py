@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+"""Run one stress-test configuration and print its measurements as JSON.
+
+Usually launched by stress_batch.py, one process per configuration so that
+peak RSS is attributable to a single workload, but it can be run by hand:
+
+    python3 stress_job.py --pop-size 1000 --mode steady-state --position
+
+Only the standard library and phylotrackpy are used.
+"""
+import argparse
+import json
+import os
+import platform
+import random
+import resource
+import sys
+import tempfile
+import time
+
+from phylotrackpy import systematics
+
+
+MODES = ("synchronous", "steady-state")
+PRUNE = ("prune", "archive", "window")
+COLLAPSE = ("off", "eager", "lazy")
+
+
+def parse_args(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--pop-size", type=int, default=1000)
+    parser.add_argument("--mutation-rate", type=float, default=0.2)
+    parser.add_argument("--mode", choices=MODES, default="synchronous")
+    parser.add_argument(
+        "--position", action="store_true",
+        help="track organisms by position instead of by Taxon",
+    )
+    parser.add_argument(
+        "--prune", choices=PRUNE, default="prune",
+        help="prune: drop extinct lineages (store_all=False); "
+        "archive: keep every taxon (store_all=True); "
+        "window: archive, but call remove_before on a sliding window",
+    )
+    parser.add_argument(
+        "--window", type=int, default=100,
+        help="number of updates kept when --prune=window",
+    )
+    parser.add_argument(
+        "--collapse", choices=COLLAPSE, default="off",
+        help="collapse unifurcations as they appear (eager) or at each "
+        "update (lazy)",
+    )
+    parser.add_argument(
+        "--no-tracking", action="store_true",
+        help="run the same workload without a systematics manager, as a "
+        "memory baseline for the Python-side state",
+    )
+    parser.add_argument("--generations", type=int, default=1000,
+                        help="stop after this many generations")
+    parser.add_argument("--seconds", type=float, default=30.0,
+                        help="stop after this much wall time")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--replicate", type=int, default=0)
+    parser.add_argument(
+        "--snapshot-dir", default=None,
+        help="where to write the snapshot (default: a temporary directory)",
+    )
+    parser.add_argument("--keep-snapshot", action="store_true")
+    return parser.parse_args(argv)
+
+
+def peak_rss_bytes():
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # ru_maxrss is in bytes on macOS and in kilobytes everywhere else
+    return peak if platform.system() == "Darwin" else peak * 1024
+
+
+def current_rss_bytes():
+    try:
+        with open("/proc/self/statm") as statm:
+            return int(statm.read().split()[1]) * os.sysconf("SC_PAGE_SIZE")
+    except (OSError, ValueError, IndexError):
+        return None
+
+
+def make_systematics(args):
+    if args.no_tracking:
+        return None
+    sys_ = systematics.Systematics(
+        store_all=args.prune != "prune",
+        store_pos=args.position,
+    )
+    if args.collapse != "off":
+        try:
+            sys_.set_collapse_unifurcations(True, lazy=args.collapse == "lazy")
+        except TypeError:
+            # Predates lazy collapse
+            raise NotImplementedError("set_collapse_unifurcations(lazy=True)")
+        except RuntimeError as err:
+            # The manager rejects this combination of settings
+            raise NotImplementedError(str(err))
+    if args.prune == "window":
+        if not hasattr(sys_, "set_remove_before_window"):
+            raise NotImplementedError("set_remove_before_window")
+        sys_.set_remove_before_window(args.window)
+    return sys_
+
+
+class Workload:
+    """Neutral model with integer genotypes.
+
+    Mutation draws a genotype that has never been seen before, so every
+    mutation founds a new taxon and the mutation rate sets how quickly taxa
+    turn over.
+    """
+
+    def __init__(self, sys_, args, rng):
+        self.sys = sys_
+        self.args = args
+        self.rng = rng
+        self.next_genotype = 1
+        self.population = [0] * args.pop_size
+        if sys_ is None:
+            self.taxa = None
+        elif args.position:
+            self.taxa = None
+            for pos, org in enumerate(self.population):
+                sys_.add_org_by_position(org, pos)
+        else:
+            self.taxa = [sys_.add_org(org) for org in self.population]
+
+    def offspring(self, parent_org):
+        if self.rng.random() < self.args.mutation_rate:
+            self.next_genotype += 1
+            return self.next_genotype
+        return parent_org
+
+    def synchronous_generation(self):
+        pop_size = self.args.pop_size
+        randrange = self.rng.randrange
+        sys_ = self.sys
+        parents = [randrange(pop_size) for _ in range(pop_size)]
+        next_population = [self.offspring(self.population[p]) for p in parents]
+
+        if sys_ is None:
+            pass
+        elif self.taxa is None:
+            for i, (org, parent) in enumerate(zip(next_population, parents)):
+                sys_.add_org_by_position(org, (i, 1), parent)
+            for i in range(pop_size):
+                sys_.remove_org_by_position(i)
+                sys_.swap_positions((i, 0), (i, 1))
+        else:
+            taxa = self.taxa
+            next_taxa = [
+                sys_.add_org(org, taxa[parent])
+                for org, parent in zip(next_population, parents)
+            ]
+            for taxon in taxa:
+                sys_.remove_org(taxon)
+            self.taxa = next_taxa
+
+        self.population = next_population
+        if sys_ is not None:
+            sys_.update()
+
+    def steady_state_generation(self):
+        # One generation is pop_size birth-death events
+        pop_size = self.args.pop_size
+        randrange = self.rng.randrange
+        sys_ = self.sys
+        population, taxa = self.population, self.taxa
+        for _ in range(pop_size):
+            parent = randrange(pop_size)
+            victim = randrange(pop_size)
+            if pop_size > 1:
+                while victim == parent:
+                    victim = randrange(pop_size)
+            org = self.offspring(population[parent])
+            if sys_ is None:
+                pass
+            elif taxa is None:
+                sys_.remove_org_by_position(victim)
+                sys_.add_org_by_position(org, victim, parent)
+            else:
+                sys_.remove_org(taxa[victim])
+                taxa[victim] = sys_.add_org(org, taxa[parent])
+            population[victim] = org
+        if sys_ is not None:
+            sys_.update()
+
+    def run(self):
+        step = (
+            self.synchronous_generation
+            if self.args.mode == "synchronous"
+            else self.steady_state_generation
+        )
+        generations = 0
+        start = time.perf_counter()
+        deadline = start + self.args.seconds
+        while generations < self.args.generations:
+            step()
+            generations += 1
+            if time.perf_counter() >= deadline:
+                break
+        return generations, time.perf_counter() - start
+
+
+def measure_snapshot(sys_, args):
+    directory = args.snapshot_dir or tempfile.mkdtemp(prefix="phylotrackpy-")
+    os.makedirs(directory, exist_ok=True)
+    path = os.path.join(directory, f"snapshot+job={job_name(args)}+ext=.csv")
+    start = time.perf_counter()
+    sys_.snapshot(path)
+    seconds = time.perf_counter() - start
+    size = os.path.getsize(path)
+    if not args.keep_snapshot:
+        os.remove(path)
+        if args.snapshot_dir is None:
+            os.rmdir(directory)
+    return size, seconds
+
+
+def job_name(args):
+    return "+".join((
+        f"pop={args.pop_size}",
+        f"mut={args.mutation_rate:g}",
+        f"mode={args.mode}",
+        f"pos={int(args.position)}",
+        f"prune={args.prune}",
+        f"collapse={args.collapse}",
+        f"track={int(not args.no_tracking)}",
+        f"rep={args.replicate}",
+    ))
+
+
+def config(args):
+    return {
+        "job": job_name(args),
+        "population size": args.pop_size,
+        "mutation rate": args.mutation_rate,
+        "mode": args.mode,
+        "position tracking": args.position,
+        "pruning": args.prune,
+        "window": args.window if args.prune == "window" else None,
+        "collapse unifurcations": args.collapse,
+        "tracking": not args.no_tracking,
+        "replicate": args.replicate,
+        "seed": args.seed,
+    }
+
+
+def run(args):
+    rng = random.Random(args.seed * 1000003 + args.replicate)
+    baseline_rss = current_rss_bytes()
+    baseline_peak = peak_rss_bytes()
+
+    sys_ = make_systematics(args)
+    workload = Workload(sys_, args, rng)
+    generations, seconds = workload.run()
+
+    end_rss = current_rss_bytes()
+    peak = peak_rss_bytes()
+    if baseline_rss is not None and end_rss is not None:
+        retained_bytes = end_rss - baseline_rss
+    else:
+        retained_bytes = peak - baseline_peak
+    result = {
+        **config(args),
+        "status": "ok",
+        "generations": generations,
+        "seconds": seconds,
+        "generations per second": generations / seconds if seconds else None,
+        "births per second": (
+            generations * args.pop_size / seconds if seconds else None
+        ),
+        "peak rss (bytes)": peak,
+        "retained rss (bytes)": retained_bytes,
+    }
+    if sys_ is None:
+        return result
+
+    num_taxa = sys_.get_num_taxa()
+    snapshot_bytes, snapshot_seconds = measure_snapshot(sys_, args)
+    return {
+        **result,
+        "taxa": num_taxa,
+        "active taxa": sys_.get_num_active(),
+        "ancestor taxa": sys_.get_num_ancestors(),
+        "outside taxa": sys_.get_num_outside(),
+        # Includes the harness's own Python objects and memory the allocator
+        # hasn't returned; stress_batch.py subtracts a run without tracking
+        "bytes per retained taxon": (
+            retained_bytes / num_taxa if num_taxa else None
+        ),
+        "snapshot size (bytes)": snapshot_bytes,
+        "snapshot seconds": snapshot_seconds,
+    }
+
+
+def main(argv=None):
+    args = parse_args(argv)
+    try:
+        result = run(args)
+    except NotImplementedError as err:
+        # The phylotrackpy under test predates a feature this job needs
+        result = {**config(args), "status": f"unsupported: {err}"}
+    print(json.dumps(result))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
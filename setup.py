@@ -33,6 +33,8 @@ setup(
     url="https://github.com/emilydolson/python-phylogeny-tracker",
     description="A python phylogeny tracking module",
     ext_modules=ext_modules,
+    # get_lineages() and the data column methods return NumPy arrays
+    install_requires=["numpy"],
     extras_require={"test": "pytest"},
     # Currently, build_ext only provides an optional "highest supported C++
     # level" feature, but in the future it may provide more features.
@@ -1,13 +1,33 @@
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
 #include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #include <pybind11/pybind11.h>
 #include <pybind11/eval.h>
 #include <pybind11/functional.h>
-// #include <pybind11/numpy.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include "Empirical/include/emp/Evolve/Systematics.hpp"
 #include "Empirical/include/emp/tools/string_utils.hpp"
@@ -172,9 +192,1062 @@ class taxon_info : public py::object {
 
 using taxon_info_t = taxon_info;
 using org_t = py::object;
-using sys_t = emp::Systematics<org_t, taxon_info_t>;
 using taxon_t = emp::Taxon<taxon_info_t>;
 using taxon_ptr = emp::Ptr<taxon_t>;
+using taxon_set_t = std::unordered_set<taxon_ptr, taxon_ptr::hash_t>;
+
+/// Iterates over a set of taxa, only creating Python wrappers for the taxa actually visited
+class taxa_iterator {
+    private:
+    const taxon_set_t * taxa;
+    const size_t * version;  // Systematics manager's count of changes to its sets of taxa
+    size_t expected_version;
+    taxon_set_t::const_iterator it;
+
+    public:
+    taxa_iterator(const taxon_set_t & _taxa, const size_t & _version)
+      : taxa(&_taxa), version(&_version), expected_version(_version), it(_taxa.begin()) {;}
+
+    taxon_ptr Next() {
+        // Any insertion or removal may have erased the taxon we point to or rehashed the set
+        if (*version != expected_version) {
+            throw std::runtime_error("Set of taxa changed during iteration");
+        }
+        if (it == taxa->end()) throw py::stop_iteration();
+        return *(it++);
+    }
+};
+
+/// Non-owning view of one of the sets of taxa stored by a systematics manager
+class taxa_view {
+    private:
+    const taxon_set_t * taxa;
+    const size_t * version;
+
+    // Where the last page ended, so that reading consecutive pages doesn't rescan the set
+    mutable std::optional<taxon_set_t::const_iterator> page_it;
+    mutable size_t page_pos = 0;
+    mutable size_t page_version = 0;
+
+    public:
+    taxa_view(const taxon_set_t & _taxa, const size_t & _version) : taxa(&_taxa), version(&_version) {;}
+
+    const taxon_set_t & GetSet() const { return *taxa; }
+    size_t GetSize() const { return taxa->size(); }
+    bool Has(taxon_ptr tax) const { return taxa->count(tax); }
+    taxa_iterator Iterate() const { return taxa_iterator(*taxa, *version); }
+
+    /// Returns the taxon with the given ID, or nullptr if it is not in this set
+    taxon_ptr FindID(size_t id) const {
+        for (taxon_ptr tax : *taxa) {
+            if (tax->GetID() == id) return tax;
+        }
+        return nullptr;
+    }
+
+    /// Returns up to `count` taxa, starting at the `start`th taxon in iteration order.
+    /// Continuing from where the previous page ended doesn't need to skip over earlier taxa.
+    std::vector<taxon_ptr> GetPage(size_t start, size_t count) const {
+        std::vector<taxon_ptr> page;
+        if (start >= taxa->size()) return page;
+        auto it = (page_it && page_pos == start && page_version == *version)
+            ? *page_it
+            : std::next(taxa->begin(), start);
+        for (; it != taxa->end() && page.size() < count; ++it) {
+            page.push_back(*it);
+        }
+        page_it = it;
+        page_pos = start + page.size();
+        page_version = *version;
+        return page;
+    }
+};
+
+/// Criteria used by `find_taxa` to select taxa without converting the whole set to Python
+struct taxon_filter {
+    size_t min_num_orgs = 0;
+    std::optional<size_t> max_num_orgs;
+    std::optional<double> origin_after;
+    std::optional<double> origin_before;
+
+    bool operator()(taxon_ptr tax) const {
+        if (tax->GetNumOrgs() < min_num_orgs) return false;
+        if (max_num_orgs && tax->GetNumOrgs() > *max_num_orgs) return false;
+        if (origin_after && !(tax->GetOriginationTime() > *origin_after)) return false;
+        if (origin_before && !(tax->GetOriginationTime() < *origin_before)) return false;
+        return true;
+    }
+};
+
+/// Copy of everything `Snapshot()` writes, taken so that the file can be written on another thread
+struct snapshot_data {
+    struct row {
+        size_t id;
+        std::optional<size_t> parent_id;
+        double origin_time;
+        double destruction_time;
+        size_t num_orgs;
+        size_t tot_orgs;
+        size_t num_offspring;
+        size_t total_offspring;
+        size_t depth;
+    };
+
+    std::vector<row> rows;
+    std::vector<std::string> extra_keys;
+    std::vector<std::vector<std::string>> extra_columns;  // One entry per row in each column
+
+    /// Writes the captured taxa in the same format as `Systematics::Snapshot()`
+    void Write(const std::string & file_path) const {
+        std::ofstream file(file_path);
+        if (!file) throw std::runtime_error("Could not open " + file_path + " to write snapshot");
+
+        file << "id,ancestor_list,origin_time,destruction_time,num_orgs,tot_orgs,num_offspring,total_offspring,depth";
+        for (const std::string & key : extra_keys) file << "," << key;
+        file << "\n";
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const row & r = rows[i];
+            file << r.id << ",";
+            if (r.parent_id) file << "[" << *r.parent_id << "],";
+            else file << "[NONE],";
+            file << r.origin_time << "," << r.destruction_time << ","
+                 << r.num_orgs << "," << r.tot_orgs << ","
+                 << r.num_offspring << "," << r.total_offspring << ","
+                 << r.depth;
+            for (const auto & column : extra_columns) file << "," << column[i];
+            file << "\n";
+        }
+
+        if (!file) throw std::runtime_error("Failed to write snapshot to " + file_path);
+    }
+};
+
+/// Handle to a snapshot being written on a background thread
+class snapshot_future {
+    private:
+    std::shared_future<void> result;
+
+    public:
+    snapshot_future(std::shared_future<void> _result) : result(_result) {;}
+
+    bool Done() const {
+        return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /// Blocks until the snapshot is written or `timeout` seconds pass; returns whether it is done
+    bool Wait(std::optional<double> timeout) const {
+        py::gil_scoped_release release;
+        if (!timeout) {
+            result.wait();
+            return true;
+        }
+        return result.wait_for(std::chrono::duration<double>(*timeout)) == std::future_status::ready;
+    }
+
+    /// Blocks until the snapshot is written, re-throwing any error that occurred while writing it
+    void Result() const {
+        Wait(std::nullopt);
+        result.get();
+    }
+};
+
+/// Snapshots still being written by background threads. These are waited on when the interpreter exits,
+/// so that a script ending right after snapshot_async doesn't leave a truncated file behind.
+class snapshot_writers {
+    private:
+    std::mutex mutex;
+    std::vector<std::shared_future<void>> pending;
+
+    public:
+    void Add(std::shared_future<void> result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.erase(std::remove_if(pending.begin(), pending.end(), [](const std::shared_future<void> & f){
+            return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }), pending.end());
+        pending.push_back(std::move(result));
+    }
+
+    void WaitAll() {
+        std::vector<std::shared_future<void>> waiting;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            waiting.swap(pending);
+        }
+        py::gil_scoped_release release;
+        for (const auto & result : waiting) result.wait();
+    }
+};
+
+snapshot_writers & get_snapshot_writers() {
+    static snapshot_writers writers;
+    return writers;
+}
+
+/// Per-taxon values keyed by taxon ID, used for custom data set from Python in bulk.
+/// Only taxa that were given a value take up space, and values are erased when their taxon is deleted.
+template <typename T>
+struct data_column {
+    T default_value;
+    std::unordered_map<size_t, T> values;
+
+    T Get(size_t id) const {
+        auto found = values.find(id);
+        return found != values.end() ? found->second : default_value;
+    }
+
+    void Erase(size_t id) { values.erase(id); }
+
+    /// Copies `values_in[i]` into the slot for `ids[i]`; IDs must already have been checked
+    void Set(const py::array_t<int64_t, py::array::c_style | py::array::forcecast> & ids, const py::object & values_in) {
+        auto converted = py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(values_in);
+        if (!converted) throw py::type_error("Values could not be converted to the type of this data column");
+        if (converted.size() != ids.size()) throw py::value_error("Must provide exactly one value per taxon");
+        const int64_t * id_data = ids.data();
+        const T * value_data = converted.data();
+        for (py::ssize_t i = 0; i < ids.size(); ++i) values[static_cast<size_t>(id_data[i])] = value_data[i];
+    }
+
+    py::array_t<T> Get(const py::array_t<int64_t, py::array::c_style | py::array::forcecast> & ids) const {
+        py::array_t<T> result(ids.size());
+        const int64_t * id_data = ids.data();
+        T * out = result.mutable_data();
+        for (py::ssize_t i = 0; i < ids.size(); ++i) out[i] = Get(static_cast<size_t>(id_data[i]));
+        return result;
+    }
+};
+
+/// Formats a double with enough significant digits that reading it back gives exactly the same value
+std::string format_double(double value) {
+    std::ostringstream out;
+    out << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+    return out.str();
+}
+
+/// Organisms of a single population (e.g. one island), tracked by position
+struct population {
+    std::vector<taxon_ptr> locations;  // Taxon of the organism at each index, if any
+    std::unordered_map<taxon_ptr, size_t, taxon_ptr::hash_t> taxon_counts;  // Organisms per taxon present
+    taxon_set_t taxa;  // Taxa present, kept alongside taxon_counts so it can be exposed as a taxa_view
+    size_t num_orgs = 0;
+
+    taxon_ptr GetAt(size_t index) const {
+        return index < locations.size() ? locations[index] : taxon_ptr();
+    }
+
+    /// Puts `tax` (or nothing, if null) at `index`, updating counts for whichever taxon it replaces.
+    /// Returns whether the set of taxa present in this population changed.
+    bool Place(size_t index, taxon_ptr tax) {
+        if (index >= locations.size()) locations.resize(index + 1);
+        taxon_ptr prev = locations[index];
+        if (prev == tax) return false;
+        bool changed = false;
+        if (prev) {
+            auto found = taxon_counts.find(prev);
+            if (--(found->second) == 0) {
+                taxon_counts.erase(found);
+                taxa.erase(prev);
+                changed = true;
+            }
+            --num_orgs;
+        }
+        if (tax) {
+            if (++taxon_counts[tax] == 1) {
+                taxa.insert(tax);
+                changed = true;
+            }
+            ++num_orgs;
+        }
+        locations[index] = tax;
+        return changed;
+    }
+};
+
+/// Systematics manager with the extra bookkeeping needed by the Python interface
+class python_systematics : public emp::Systematics<org_t, taxon_info_t> {
+    public:
+    using base_t = emp::Systematics<org_t, taxon_info_t>;
+    using snapshot_fun_t = std::function<std::string(const taxon_t &)>;
+    using ids_t = py::array_t<int64_t, py::array::c_style | py::array::forcecast>;
+
+    private:
+    std::vector<std::pair<std::string, snapshot_fun_t>> snapshot_funs;
+    std::map<std::string, data_column<double>> float_data;
+    std::map<std::string, data_column<int64_t>> int_data;
+
+    // Populations indexed by pop ID, used instead of the base class's positions when track_populations is set
+    bool track_populations = false;
+    std::deque<population> populations;  // A deque, so that taxa views of a population survive adding more
+    std::optional<emp::WorldPosition> pending_removal;  // Set by RemoveOrgAfterRepro, cleared on next birth
+
+    // Outside taxa bucketed by the earliest time they could be removed by RemoveBefore (never later than
+    // the last destruction time along their lineage), outside taxa that can't be removed until a living
+    // ancestor goes extinct, and the outside offspring of each taxon (by ID). Together these let
+    // RemoveBefore skip taxa that can't be removed yet.
+    std::map<double, std::vector<taxon_ptr>> archive_by_time;
+    std::unordered_map<taxon_ptr, std::vector<taxon_ptr>, taxon_ptr::hash_t> blocked_by;
+    std::unordered_map<size_t, taxon_set_t> archived_offspring;
+    std::optional<int> remove_before_window;
+
+    // Every stored taxon by ID. Eager collapse deletes ancestors without any hook firing, so an entry is
+    // only trusted once its taxon is found in one of the taxon sets, and stale entries are swept out as
+    // new taxa are created.
+    std::unordered_map<size_t, taxon_ptr> taxa_by_id;
+
+    // Incremented whenever a taxon is added to or removed from the active, ancestor, or outside sets
+    size_t taxa_version = 0;
+
+    // With lazy collapse, taxa are marked here at the moment eager collapse would have removed them (on going
+    // extinct with one offspring, or on dropping to one offspring while extinct) and spliced out together by
+    // Update(). Splicing shortens depths behind the base class's running depth total and its cached maximum,
+    // so the difference is kept in depth_correction and the maximum is tracked here once depths have moved.
+    bool lazy_collapse = false;
+    taxon_set_t unifurcations;
+    int64_t depth_correction = 0;
+    bool depths_rewritten = false;
+    mutable int active_max_depth = -1;  // -1 when it has to be recomputed
+
+    population & GetPop(size_t pop_id) {
+        if (pop_id >= populations.size()) populations.resize(pop_id + 1);
+        return populations[pop_id];
+    }
+
+    const population & GetPop(size_t pop_id) const {
+        static const population empty;
+        return pop_id < populations.size() ? populations[pop_id] : empty;
+    }
+
+    public:
+    using base_t::AddOrg;
+    using base_t::RemoveOrg;
+    using base_t::RemoveOrgAfterRepro;
+    using base_t::SetNextParent;
+    using base_t::GetTaxonAt;
+
+    python_systematics(
+        std::function<taxon_info_t(org_t &)> calc_taxon,
+        bool store_active=true,
+        bool store_ancestors=true,
+        bool store_all=false,
+        bool store_pos=true
+    ) : base_t(calc_taxon, store_active, store_ancestors, store_all, store_pos) {
+        std::function<void(taxon_ptr, org_t &)> new_fun = [this](taxon_ptr tax, org_t &){
+            ++taxa_version;
+            if (active_max_depth != -1) active_max_depth = std::max(active_max_depth, static_cast<int>(tax->GetDepth()));
+            if (taxa_by_id.size() > 2 * GetNumTaxa() + 64) SweepDeleted();
+            taxa_by_id[tax->GetID()] = tax;
+        };
+        std::function<void(taxon_ptr)> extinct_fun = [this](taxon_ptr tax){
+            ++taxa_version;
+            ReleaseBlocked(tax);
+            if (static_cast<int>(tax->GetDepth()) == active_max_depth) active_max_depth = -1;
+            if (lazy_collapse && tax->GetNumOff() == 1) unifurcations.insert(tax);
+        };
+        std::function<void(taxon_ptr)> archive_fun = [this](taxon_ptr tax){ ++taxa_version; ArchiveTaxon(tax); };
+        OnNew(new_fun);
+        OnExtinct(extinct_fun);
+        OnPrune(archive_fun);
+    }
+
+    const size_t & GetTaxaVersion() const { return taxa_version; }
+
+    /// Returns the stored taxon with the given ID, or nullptr if no such taxon is stored
+    taxon_ptr FindTaxon(size_t id) const {
+        auto found = taxa_by_id.find(id);
+        if (found == taxa_by_id.end() || !IsStored(found->second)) return nullptr;
+        return found->second->GetID() == id ? found->second : nullptr;
+    }
+
+    void LoadFromFile(const std::string & file_path, const std::string & info_col, bool assume_leaves_extant, bool adjust_total_offspring) {
+        // Loading replaces every taxon, so anything pointing at the old ones has to go
+        ++taxa_version;
+        for (population & pop : populations) pop = population();
+        pending_removal.reset();
+        archive_by_time.clear();
+        blocked_by.clear();
+        archived_offspring.clear();
+        unifurcations.clear();
+        depth_correction = 0;
+        depths_rewritten = false;
+        active_max_depth = -1;
+        for (auto & [key, column] : float_data) column.values.clear();
+        for (auto & [key, column] : int_data) column.values.clear();
+        base_t::LoadFromFile(file_path, info_col, assume_leaves_extant, adjust_total_offspring);
+        for (taxon_ptr tax : GetOutside()) AddToArchiveIndex(tax);
+        taxa_by_id.clear();
+        for (const taxon_set_t * tax_set : {&GetActive(), &GetAncestors(), &GetOutside()}) {
+            for (taxon_ptr tax : *tax_set) taxa_by_id[tax->GetID()] = tax;
+        }
+    }
+
+    void SetUpdate(size_t ud) {
+        base_t::SetUpdate(ud);
+        ApplyRemoveBeforeWindow();
+    }
+
+    void Update() {
+        if (lazy_collapse) SpliceUnifurcations();
+        base_t::Update();
+        ApplyRemoveBeforeWindow();
+    }
+
+    // Eager collapsing deletes ancestors without pruning them, which would leave outside taxa (and the
+    // index RemoveBefore uses) pointing at deleted parents, so the two can't be combined. Lazy collapse
+    // re-parents outside taxa as it splices, so it can.
+
+    void SetCollapseUnifurcations(bool val, bool lazy=false) {
+        if (val && !lazy && GetStoreOutside()) {
+            throw std::runtime_error("Eagerly collapsing unifurcations cannot be combined with storing outside taxa");
+        }
+        if (lazy_collapse && !(val && lazy)) {
+            if (val) SpliceUnifurcations();  // Switching to eager collapse, which only acts on new events
+            unifurcations.clear();
+        }
+        lazy_collapse = val && lazy;
+        base_t::SetCollapseUnifurcations(val && !lazy);
+    }
+
+    bool GetCollapseUnifurcations() const { return base_t::GetCollapseUnifurcations() || lazy_collapse; }
+    bool GetLazyCollapse() const { return lazy_collapse; }
+
+    void SetStoreOutside(bool val) {
+        if (val && base_t::GetCollapseUnifurcations()) {
+            throw std::runtime_error("Storing outside taxa cannot be combined with eagerly collapsing unifurcations");
+        }
+        base_t::SetStoreOutside(val);
+    }
+
+    double GetAveDepth() const {
+        if (!depth_correction) return base_t::GetAveDepth();
+        const double num_orgs = GetTotalOrgs();
+        return num_orgs ? (base_t::GetAveDepth() * num_orgs - depth_correction) / num_orgs : 0.0;
+    }
+
+    int GetMaxDepth() const {
+        // The base class caches the maximum, which splicing can leave too high, so once depths have moved
+        // the maximum is cached here instead (and kept up to date by the new and extinct hooks)
+        if (!depths_rewritten) return base_t::GetMaxDepth();
+        if (active_max_depth == -1) {
+            active_max_depth = 0;
+            for (taxon_ptr tax : GetActive()) {
+                active_max_depth = std::max(active_max_depth, static_cast<int>(tax->GetDepth()));
+            }
+        }
+        return active_max_depth;
+    }
+
+    void SetRemoveBeforeWindow(std::optional<int> window) { remove_before_window = window; }
+    std::optional<int> GetRemoveBeforeWindow() const { return remove_before_window; }
+
+    /// Deletes every outside taxon that went extinct before `ud` and whose ancestors all went extinct
+    /// before `ud` as well. Outside taxa that are kept but whose parent is deleted become roots.
+    /// Only outside taxa indexed under a time before `ud` (and their ancestors) are visited.
+    void RemoveBefore(int ud) {
+        const auto stop = archive_by_time.lower_bound(ud);
+        std::vector<taxon_ptr> candidates;
+        for (auto it = archive_by_time.begin(); it != stop; ++it) {
+            candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+        archive_by_time.erase(archive_by_time.begin(), stop);
+
+        // Candidates that can't be removed yet are re-indexed under the time they will be removable
+        std::unordered_map<taxon_ptr, lineage_info, taxon_ptr::hash_t> lineages;
+        taxon_set_t removed;
+        for (taxon_ptr tax : candidates) {
+            const lineage_info info = GetLineageInfo(tax, lineages);
+            if (info.living_ancestor) blocked_by[info.living_ancestor].push_back(tax);
+            else if (info.last_destruction < ud) removed.insert(tax);
+            else archive_by_time[info.last_destruction].push_back(tax);
+        }
+
+        for (taxon_ptr tax : removed) {
+            if (auto found = archived_offspring.find(tax->GetID()); found != archived_offspring.end()) {
+                for (taxon_ptr offspring : found->second) {
+                    if (!removed.count(offspring)) offspring->NullifyParent();
+                }
+                archived_offspring.erase(found);
+            }
+            taxon_ptr parent = tax->GetParent();
+            if (parent && !removed.count(parent)) {
+                if (auto found = archived_offspring.find(parent->GetID()); found != archived_offspring.end()) {
+                    found->second.erase(tax);
+                    if (found->second.empty()) archived_offspring.erase(found);
+                }
+            }
+        }
+
+        // The set itself isn't const; the base class just doesn't offer a mutable accessor for it
+        taxon_set_t & outside = const_cast<taxon_set_t &>(GetOutside());
+        if (!removed.empty()) ++taxa_version;
+        for (taxon_ptr tax : removed) {
+            outside.erase(tax);
+            taxa_by_id.erase(tax->GetID());
+            EraseData(tax);
+            tax.Delete();
+        }
+    }
+
+    void AddSnapshotFun(const snapshot_fun_t & fun, const std::string & key, const std::string & desc="") {
+        base_t::AddSnapshotFun(fun, key, desc);
+        snapshot_funs.emplace_back(key, fun);
+    }
+
+    /// Adds a typed per-taxon data column that is written by `Snapshot()` under `key`
+    void AddDataColumn(const std::string & key, const std::string & dtype, const py::object & default_value, const std::string & desc) {
+        if (float_data.count(key) || int_data.count(key)) {
+            throw py::value_error("There is already a data column named " + key);
+        }
+        if (dtype == "float64") {
+            const data_column<double> * column = &(float_data[key] = {default_value.cast<double>(), {}});
+            AddSnapshotFun([column](const taxon_t & tax){ return format_double(column->Get(tax.GetID())); }, key, desc);
+        } else if (dtype == "int64") {
+            const data_column<int64_t> * column = &(int_data[key] = {default_value.cast<int64_t>(), {}});
+            AddSnapshotFun([column](const taxon_t & tax){ return emp::to_string(column->Get(tax.GetID())); }, key, desc);
+        } else {
+            throw py::value_error("dtype must be \"float64\" or \"int64\"");
+        }
+    }
+
+    void SetData(const std::string & key, const ids_t & ids, const py::object & values) {
+        CheckIDs(ids);
+        if (auto found = float_data.find(key); found != float_data.end()) found->second.Set(ids, values);
+        else if (auto found = int_data.find(key); found != int_data.end()) found->second.Set(ids, values);
+        else throw py::key_error("No data column named " + key);
+    }
+
+    py::array GetData(const std::string & key, const ids_t & ids) const {
+        CheckIDs(ids);
+        if (auto found = float_data.find(key); found != float_data.end()) return found->second.Get(ids);
+        if (auto found = int_data.find(key); found != int_data.end()) return found->second.Get(ids);
+        throw py::key_error("No data column named " + key);
+    }
+
+    /// Copies the current state of every stored taxon, evaluating custom snapshot functions as it goes
+    snapshot_data CaptureSnapshot() const {
+        snapshot_data data;
+        data.rows.reserve(GetNumTaxa());
+        data.extra_columns.resize(snapshot_funs.size());
+        for (const auto & [key, fun] : snapshot_funs) data.extra_keys.push_back(key);
+
+        for (const taxon_set_t * tax_set : {&GetActive(), &GetAncestors(), &GetOutside()}) {
+            for (taxon_ptr tax : *tax_set) {
+                snapshot_data::row & row = data.rows.emplace_back();
+                row.id = tax->GetID();
+                if (tax->GetParent()) row.parent_id = tax->GetParent()->GetID();
+                row.origin_time = tax->GetOriginationTime();
+                row.destruction_time = tax->GetDestructionTime();
+                row.num_orgs = tax->GetNumOrgs();
+                row.tot_orgs = tax->GetTotOrgs();
+                row.num_offspring = tax->GetNumOff();
+                row.total_offspring = tax->GetTotalOffspring();
+                row.depth = tax->GetDepth();
+                for (size_t i = 0; i < snapshot_funs.size(); ++i) {
+                    data.extra_columns[i].push_back(snapshot_funs[i].second(*tax));
+                }
+            }
+        }
+        return data;
+    }
+
+    /// Captures the current phylogeny and writes it to `file_path` on a background thread.
+    /// The thread is detached, so dropping the returned handle never waits for the write.
+    snapshot_future SnapshotAsync(const std::string & file_path) const {
+        auto data = std::make_shared<snapshot_data>(CaptureSnapshot());
+        std::promise<void> written;
+        std::shared_future<void> result = written.get_future().share();
+        std::thread([data, file_path, written = std::move(written)]() mutable {
+            try {
+                data->Write(file_path);
+                written.set_value();
+            } catch (...) {
+                written.set_exception(std::current_exception());
+            }
+        }).detach();
+        get_snapshot_writers().Add(result);
+        return snapshot_future(result);
+    }
+
+    void SetTrackPopulations(bool val) {
+        if (val == track_populations) return;
+        if (GetTotalOrgs() > 0) {
+            throw std::runtime_error("Population tracking must be configured before adding organisms");
+        }
+        if (val && GetTrackSynchronous()) {
+            throw std::runtime_error("Population tracking cannot be combined with synchronous tracking");
+        }
+        track_populations = val;
+    }
+    bool GetTrackPopulations() const { return track_populations; }
+
+    void SetTrackSynchronous(bool val) {
+        if (val && track_populations) {
+            throw std::runtime_error("Synchronous tracking cannot be combined with population tracking");
+        }
+        base_t::SetTrackSynchronous(val);
+    }
+    size_t GetNumPops() const { return populations.size(); }
+
+    // Position-based notifications. When tracking populations, positions are looked up in
+    // `populations` (so every pop ID is a separate population) and the base class is
+    // notified by taxon instead.
+
+    void AddOrg(org_t & org, emp::WorldPosition pos, emp::WorldPosition parent_pos) {
+        if (!track_populations) {
+            base_t::AddOrg(org, pos, parent_pos);
+            return;
+        }
+        AddOrgToPop(org, pos, GetTaxonAt(parent_pos));
+    }
+
+    void AddOrg(org_t & org, emp::WorldPosition pos) {
+        if (!track_populations) {
+            base_t::AddOrg(org, pos);
+            return;
+        }
+        taxon_ptr parent = GetNextParent();
+        base_t::SetNextParent(taxon_ptr());
+        AddOrgToPop(org, pos, parent);
+    }
+
+    bool RemoveOrg(emp::WorldPosition pos) {
+        if (!track_populations) return base_t::RemoveOrg(pos);
+        taxon_ptr tax = GetTaxonAt(pos);
+        emp_assert(tax, "Trying to remove an organism from an empty position");
+        PlaceInPop(pos, taxon_ptr());
+        return base_t::RemoveOrg(tax);
+    }
+
+    void RemoveOrgAfterRepro(emp::WorldPosition pos) {
+        if (!track_populations) {
+            base_t::RemoveOrgAfterRepro(pos);
+            return;
+        }
+        taxon_ptr tax = GetTaxonAt(pos);
+        emp_assert(tax, "Trying to remove an organism from an empty position");
+        if (pending_removal) {
+            PlaceInPop(*pending_removal, taxon_ptr());
+        }
+        // The organism stays at its position until the next birth, since it may be the parent
+        pending_removal = pos;
+        base_t::RemoveOrgAfterRepro(tax);
+    }
+
+    void SetNextParent(emp::WorldPosition pos) {
+        if (!track_populations) {
+            base_t::SetNextParent(pos);
+            return;
+        }
+        base_t::SetNextParent(GetTaxonAt(pos));
+    }
+
+    void SwapPositions(emp::WorldPosition pos1, emp::WorldPosition pos2) {
+        if (!track_populations) {
+            base_t::SwapPositions(pos1, pos2);
+            return;
+        }
+        taxon_ptr tax1 = GetTaxonAt(pos1);
+        taxon_ptr tax2 = GetTaxonAt(pos2);
+        PlaceInPop(pos1, tax2);
+        PlaceInPop(pos2, tax1);
+    }
+
+    bool IsTaxonAt(emp::WorldPosition pos) const {
+        if (!track_populations) return base_t::IsTaxonAt(pos);
+        return static_cast<bool>(GetTaxonAt(pos));
+    }
+
+    taxon_ptr GetTaxonAt(emp::WorldPosition pos) const {
+        if (!track_populations) return base_t::GetTaxonAt(pos);
+        if (!pos.IsValid()) return taxon_ptr();
+        return GetPop(pos.GetPopID()).GetAt(pos.GetIndex());
+    }
+
+    // Per-population statistics. These are maintained incrementally or computed from
+    // the taxa present in a single population, and are only available when tracking populations.
+
+    size_t GetPopTotalOrgs(size_t pop_id) const {
+        RequireTrackPopulations();
+        return GetPop(pop_id).num_orgs;
+    }
+
+    size_t GetPopNumActive(size_t pop_id) const {
+        RequireTrackPopulations();
+        return GetPop(pop_id).taxa.size();
+    }
+
+    /// Populations that haven't been used yet all share the same empty set, so reading doesn't create them
+    taxa_view GetPopActive(size_t pop_id) const {
+        RequireTrackPopulations();
+        return taxa_view(GetPop(pop_id).taxa, taxa_version);
+    }
+
+    /// Shannon diversity of a population, weighting each taxon by its number of organisms there
+    double CalcPopDiversity(size_t pop_id) const {
+        RequireTrackPopulations();
+        const population & pop = GetPop(pop_id);
+        double entropy = 0.0;
+        for (const auto & [tax, count] : pop.taxon_counts) {
+            const double p = static_cast<double>(count) / static_cast<double>(pop.num_orgs);
+            entropy -= p * std::log2(p);
+        }
+        return entropy;
+    }
+
+    /// Most-recent common ancestor of the organisms in a population (nullptr if there is none).
+    /// Each ancestor is visited at most once, no matter how many taxa in the population share it.
+    taxon_ptr GetPopMRCA(size_t pop_id) const {
+        RequireTrackPopulations();
+        const population & pop = GetPop(pop_id);
+        if (pop.taxon_counts.empty()) return taxon_ptr();
+
+        // Lineage of one taxon in the population; every other lineage must join it
+        auto it = pop.taxon_counts.begin();
+        std::vector<taxon_ptr> lineage;
+        std::unordered_map<taxon_ptr, size_t, taxon_ptr::hash_t> joins;  // Where each visited taxon's lineage joins `lineage`
+        for (taxon_ptr tax = it->first; tax; tax = tax->GetParent()) {
+            joins.emplace(tax, lineage.size());
+            lineage.push_back(tax);
+        }
+
+        size_t mrca_index = 0;
+        std::vector<taxon_ptr> path;
+        for (++it; it != pop.taxon_counts.end(); ++it) {
+            path.clear();
+            taxon_ptr tax = it->first;
+            while (tax && !joins.count(tax)) {
+                path.push_back(tax);
+                tax = tax->GetParent();
+            }
+            if (!tax) return taxon_ptr();  // Lineages lead back to different roots
+            const size_t join = joins[tax];
+            for (taxon_ptr visited : path) joins.emplace(visited, join);
+            mrca_index = std::max(mrca_index, join);
+        }
+        return lineage[mrca_index];
+    }
+
+    private:
+    void RequireTrackPopulations() const {
+        if (!track_populations) {
+            throw std::runtime_error("Per-population statistics require set_track_populations(True)");
+        }
+    }
+
+    /// Throws a KeyError if any ID doesn't belong to a stored taxon, so that values can't be set for a
+    /// taxon that has already been deleted (and would never be erased)
+    void CheckIDs(const ids_t & ids) const {
+        const int64_t * id_data = ids.data();
+        for (py::ssize_t i = 0; i < ids.size(); ++i) {
+            if (id_data[i] < 0 || !FindTaxon(static_cast<size_t>(id_data[i]))) {
+                throw py::key_error("No taxon with ID " + std::to_string(id_data[i]) + " is being tracked");
+            }
+        }
+    }
+
+    /// Whether `tax` is in one of the taxon sets. Only the pointer is compared, so this is safe to call
+    /// on a taxon that has already been deleted.
+    bool IsStored(taxon_ptr tax) const {
+        return GetActive().count(tax) || GetAncestors().count(tax) || GetOutside().count(tax);
+    }
+
+    /// Drops index entries and data for taxa that were deleted behind our back (by eager collapse)
+    void SweepDeleted() {
+        for (auto it = taxa_by_id.begin(); it != taxa_by_id.end();) {
+            if (IsStored(it->second)) ++it;
+            else it = taxa_by_id.erase(it);
+        }
+        auto sweep_column = [this](auto & column){
+            for (auto it = column.values.begin(); it != column.values.end();) {
+                if (taxa_by_id.count(it->first)) ++it;
+                else it = column.values.erase(it);
+            }
+        };
+        for (auto & [key, column] : float_data) sweep_column(column);
+        for (auto & [key, column] : int_data) sweep_column(column);
+    }
+
+    /// Drops any custom data stored for a taxon that is about to be deleted
+    void EraseData(taxon_ptr tax) {
+        for (auto & [key, column] : float_data) column.Erase(tax->GetID());
+        for (auto & [key, column] : int_data) column.Erase(tax->GetID());
+    }
+
+    struct lineage_info {
+        double last_destruction = -std::numeric_limits<double>::infinity();
+        taxon_ptr living_ancestor;  // Nearest taxon in the lineage that hasn't gone extinct, if any
+    };
+
+    /// Summarizes the lineage of `tax` (including `tax` itself), memoizing every taxon visited so
+    /// that lineages sharing ancestors are only walked once
+    lineage_info GetLineageInfo(taxon_ptr tax, std::unordered_map<taxon_ptr, lineage_info, taxon_ptr::hash_t> & memo) const {
+        std::vector<taxon_ptr> path;
+        lineage_info info;
+        for (taxon_ptr curr = tax; curr; curr = curr->GetParent()) {
+            if (auto found = memo.find(curr); found != memo.end()) {
+                info = found->second;
+                break;
+            }
+            path.push_back(curr);
+        }
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            const double time = (*it)->GetDestructionTime();
+            if (std::isinf(time)) info.living_ancestor = *it;
+            else info.last_destruction = std::max(info.last_destruction, time);
+            memo.emplace(*it, info);
+        }
+        return info;
+    }
+
+    /// Called when `tax` goes extinct: outside taxa waiting on it may now be removable
+    void ReleaseBlocked(taxon_ptr tax) {
+        auto found = blocked_by.find(tax);
+        if (found == blocked_by.end()) return;
+        double time = tax->GetDestructionTime();
+        if (std::isinf(time)) time = GetUpdate();
+        auto & bucket = archive_by_time[time];
+        bucket.insert(bucket.end(), found->second.begin(), found->second.end());
+        blocked_by.erase(found);
+    }
+
+    void AddToArchiveIndex(taxon_ptr tax) {
+        double time = tax->GetDestructionTime();
+        if (std::isinf(time)) time = GetUpdate();  // Not marked extinct yet, so it dies now
+        archive_by_time[time].push_back(tax);
+        if (tax->GetParent()) archived_offspring[tax->GetParent()->GetID()].insert(tax);
+    }
+
+    /// Called whenever a taxon is pruned from the tree; it is about to move to the outside set (if stored)
+    void ArchiveTaxon(taxon_ptr tax) {
+        if (lazy_collapse) {
+            const taxon_ptr parent = tax->GetParent();
+            if (unifurcations.erase(tax) && parent) {
+                // Eager collapse would already have re-added this taxon's offspring to its parent, which
+                // counts towards total_offspring all the way up; the lineage ends here, so count it now
+                parent->AddTotalOffspring();
+            }
+            // The parent is about to lose this offspring; with one left and no organisms it is a unifurcation
+            if (parent && !parent->GetNumOrgs() && parent->GetNumOff() == 2) unifurcations.insert(parent);
+        }
+        if (GetStoreOutside()) {
+            AddToArchiveIndex(tax);
+        } else {
+            // Not kept, so it is deleted as soon as it has been pruned
+            taxa_by_id.erase(tax->GetID());
+            EraseData(tax);
+        }
+    }
+
+    /// Splices every chain of unifurcations marked since the last call out of the tree in one pass, then
+    /// renumbers the depths of each subtree that moved up exactly once.
+    ///
+    /// The result matches what eager collapse would have left: the spliced taxa are dropped from the
+    /// ancestor set, each surviving parent gets the same offspring and total_offspring it would have had
+    /// after one collapse per spliced taxon, chains at a root leave their bottom taxon as the new root (so
+    /// the number of roots is unchanged), and depths are renumbered from the new parents. The cached MRCA
+    /// never needs fixing up: it is found by walking down from the root past unifurcations, so it can only
+    /// be a unifurcation if the cache is stale, and such a taxon is left in place until the next call.
+    void SpliceUnifurcations() {
+        taxon_set_t splice;
+        const taxon_ptr mrca = GetMRCA();
+        for (taxon_ptr tax : unifurcations) {
+            if (!tax->GetNumOrgs() && tax->GetNumOff() == 1 && tax != mrca) splice.insert(tax);
+        }
+        const bool keep_mrca = mrca && unifurcations.count(mrca);
+        unifurcations.clear();
+        if (keep_mrca) unifurcations.insert(mrca);
+        if (splice.empty()) return;
+
+        std::vector<taxon_ptr> tops;
+        for (taxon_ptr tax : splice) {
+            if (!tax->GetParent() || !splice.count(tax->GetParent())) tops.push_back(tax);
+        }
+
+        // Taxa given a new parent, with their depth beforehand, as the roots of the subtrees to renumber
+        std::vector<std::pair<size_t, taxon_ptr>> moved;
+        taxon_set_t & ancestor_set = const_cast<taxon_set_t &>(GetAncestors());
+        for (taxon_ptr top : tops) {
+            const taxon_ptr parent = top->GetParent();
+            std::vector<taxon_ptr> chain;
+            taxon_ptr bottom = top;
+            while (splice.count(bottom)) {
+                chain.push_back(bottom);
+                bottom = *bottom->GetOffspring().begin();
+            }
+            if (parent) {
+                parent->RemoveOffspring(top);
+                parent->AddOffspring(bottom);
+                // Eager collapse re-adds the offspring once per collapsed taxon, and each re-add counts
+                // towards total_offspring all the way up
+                for (size_t i = 1; i < chain.size(); ++i) parent->AddTotalOffspring();
+                bottom->SetParent(parent);
+            } else {
+                bottom->NullifyParent();
+            }
+            moved.emplace_back(bottom->GetDepth(), bottom);
+
+            for (taxon_ptr tax : chain) {
+                if (auto found = archived_offspring.find(tax->GetID()); found != archived_offspring.end()) {
+                    const taxon_set_t orphans = std::move(found->second);
+                    archived_offspring.erase(found);
+                    for (taxon_ptr offspring : orphans) {
+                        if (parent) {
+                            offspring->SetParent(parent);
+                            archived_offspring[parent->GetID()].insert(offspring);
+                        } else {
+                            offspring->NullifyParent();
+                        }
+                        moved.emplace_back(offspring->GetDepth(), offspring);
+                    }
+                }
+                ancestor_set.erase(tax);
+                taxa_by_id.erase(tax->GetID());
+                EraseData(tax);
+                tax.Delete();
+            }
+        }
+        ++taxa_version;
+
+        // Shallowest first, so a subtree nested inside another that moved is already correct when reached
+        std::sort(moved.begin(), moved.end(), [](const auto & a, const auto & b){ return a.first < b.first; });
+        std::vector<taxon_ptr> stack;
+        for (const auto & [old_depth, root] : moved) {
+            stack.push_back(root);
+            while (!stack.empty()) {
+                const taxon_ptr tax = stack.back();
+                stack.pop_back();
+                const size_t depth = tax->GetParent() ? tax->GetParent()->GetDepth() + 1 : 0;
+                if (depth == tax->GetDepth()) continue;
+                depth_correction += static_cast<int64_t>(tax->GetNumOrgs())
+                                    * (static_cast<int64_t>(tax->GetDepth()) - static_cast<int64_t>(depth));
+                tax->SetDepth(depth);
+                stack.insert(stack.end(), tax->GetOffspring().begin(), tax->GetOffspring().end());
+                if (auto found = archived_offspring.find(tax->GetID()); found != archived_offspring.end()) {
+                    stack.insert(stack.end(), found->second.begin(), found->second.end());
+                }
+            }
+        }
+        depths_rewritten = true;
+        active_max_depth = -1;
+    }
+
+    void ApplyRemoveBeforeWindow() {
+        if (!remove_before_window) return;
+        const int cutoff = static_cast<int>(GetUpdate()) - *remove_before_window;
+        if (!archive_by_time.empty() && archive_by_time.begin()->first < cutoff) RemoveBefore(cutoff);
+    }
+
+    void PlaceInPop(emp::WorldPosition pos, taxon_ptr tax) {
+        if (GetPop(pos.GetPopID()).Place(pos.GetIndex(), tax)) ++taxa_version;
+    }
+
+    void AddOrgToPop(org_t & org, emp::WorldPosition pos, taxon_ptr parent) {
+        taxon_ptr tax = base_t::AddOrg(org, parent);
+        if (pending_removal) {
+            PlaceInPop(*pending_removal, taxon_ptr());
+            pending_removal.reset();
+        }
+        PlaceInPop(pos, tax);
+    }
+};
+
+using sys_t = python_systematics;
+
+/// Returns the taxon sets named by `which` ("active", "ancestors", "outside", or "all")
+std::vector<const taxon_set_t *> select_taxa(const sys_t & sys, const std::string & which) {
+    if (which == "active") return {&sys.GetActive()};
+    if (which == "ancestors") return {&sys.GetAncestors()};
+    if (which == "outside") return {&sys.GetOutside()};
+    if (which == "all") return {&sys.GetActive(), &sys.GetAncestors(), &sys.GetOutside()};
+    throw py::value_error("taxa must be one of \"active\", \"ancestors\", \"outside\", or \"all\"");
+}
+
+/// Returns the stored taxa with the given IDs (in the same order), throwing a KeyError for unknown IDs
+std::vector<taxon_ptr> find_taxa_by_id(const sys_t & sys, const std::vector<size_t> & ids) {
+    std::vector<taxon_ptr> taxa;
+    taxa.reserve(ids.size());
+    for (size_t id : ids) {
+        taxon_ptr tax = sys.FindTaxon(id);
+        if (!tax) throw py::key_error("No taxon with ID " + std::to_string(id) + " is being tracked");
+        taxa.push_back(tax);
+    }
+    return taxa;
+}
+
+/// Hands ownership of a vector's buffer to a NumPy array without copying it
+template <typename T>
+py::array_t<T> to_numpy(std::vector<T> && vec) {
+    auto * data = new std::vector<T>(std::move(vec));
+    py::capsule owner(data, [](void * ptr){ delete static_cast<std::vector<T> *>(ptr); });
+    return py::array_t<T>(data->size(), data->data(), owner);
+}
+
+/// Builds the lineage (the taxon itself, then each ancestor back to its root) of every taxon in `taxa`.
+/// Lineages are returned CSR-style: lineage i is ids[offsets[i]:offsets[i+1]].
+/// Each taxon's parent pointer is only followed once; once a walk reaches a taxon that is already
+/// part of an earlier lineage, the rest of that lineage is copied instead of walked again. The copies
+/// still make the output (and the time to write it) the sum of the lineage lengths; get_lineage_tree
+/// returns the same information in space proportional to the number of distinct taxa.
+py::tuple get_lineages(const std::vector<taxon_ptr> & taxa) {
+    std::vector<size_t> offsets{0};
+    std::vector<size_t> ids;
+    offsets.reserve(taxa.size() + 1);
+
+    // Position in `ids` where each visited taxon's own lineage starts, and the lineage containing it
+    std::unordered_map<taxon_ptr, std::pair<size_t, size_t>, taxon_ptr::hash_t> visited;
+
+    for (taxon_ptr tax : taxa) {
+        const size_t lineage = offsets.size() - 1;
+        for (taxon_ptr curr = tax; curr; curr = curr->GetParent()) {
+            auto found = visited.find(curr);
+            if (found != visited.end()) {
+                const auto [start, prev_lineage] = found->second;
+                const size_t length = offsets[prev_lineage + 1] - start;
+                ids.resize(ids.size() + length);
+                std::copy_n(ids.begin() + start, length, ids.end() - length);
+                break;
+            }
+            visited.emplace(curr, std::make_pair(ids.size(), lineage));
+            ids.push_back(curr->GetID());
+        }
+        offsets.push_back(ids.size());
+    }
+
+    return py::make_tuple(to_numpy(std::move(offsets)), to_numpy(std::move(ids)));
+}
+
+/// Builds the union of the lineages of every taxon in `taxa` as a tree: ids holds each distinct taxon once,
+/// parents[k] is the position in ids of the parent of ids[k] (-1 for a root), and index[i] is the position
+/// in ids of taxa[i]. Each taxon is visited once no matter how many lineages share it.
+py::tuple get_lineage_tree(const std::vector<taxon_ptr> & taxa) {
+    std::vector<size_t> ids;
+    std::vector<int64_t> parents;
+    std::vector<int64_t> index;
+    index.reserve(taxa.size());
+
+    std::unordered_map<taxon_ptr, int64_t, taxon_ptr::hash_t> positions;
+    std::vector<taxon_ptr> path;
+    for (taxon_ptr tax : taxa) {
+        path.clear();
+        int64_t known = -1;  // Position of the nearest taxon in the lineage that was already added
+        for (taxon_ptr curr = tax; curr; curr = curr->GetParent()) {
+            if (auto found = positions.find(curr); found != positions.end()) {
+                known = found->second;
+                break;
+            }
+            path.push_back(curr);
+        }
+        // Add the new part of the lineage rootmost first, so each parent already has a position
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            positions.emplace(*it, ids.size());
+            ids.push_back((*it)->GetID());
+            parents.push_back(known);
+            known = ids.size() - 1;
+        }
+        index.push_back(known);
+    }
+
+    return py::make_tuple(to_numpy(std::move(ids)), to_numpy(std::move(parents)), to_numpy(std::move(index)));
+}
 
 
 PYBIND11_MODULE(systematics, m) {
@@ -184,6 +1257,8 @@ PYBIND11_MODULE(systematics, m) {
     //     .def_readwrite("data", &emp::datastruct::python::data)
     //     ;
 
+    py::module_::import("atexit").attr("register")(py::cpp_function([](){ get_snapshot_writers().WaitAll(); }));
+
     m.def("encode_taxon", &encode_taxon, R"mydelimiter(
         Encode a Python object as a string that streams as a single token and can be deserialized using `eval`.
 
@@ -261,6 +1336,67 @@ PYBIND11_MODULE(systematics, m) {
         // .def("get_data", [](taxon_t & self){return self.GetData();})
         ;
 
+    py::class_<taxa_iterator>(m, "TaxaIterator")
+        .def("__iter__", [](taxa_iterator & self) -> taxa_iterator & { return self; }, py::return_value_policy::reference_internal)
+        .def("__next__", &taxa_iterator::Next, py::return_value_policy::reference_internal);
+
+    py::class_<taxa_view>(m, "TaxaView", R"mydelimiter(
+            A read-only view of one of the sets of taxa stored by a systematics manager.
+            Taxa are only converted to Python objects as they are accessed, so taking the length of a view or checking membership is cheap even for very large phylogenies.
+            The view reflects the current state of the systematics manager. If any taxon is created, goes extinct, or is removed while you are iterating over a view, the next step of the iteration raises a RuntimeError (even if the number of taxa stayed the same).
+            To change the phylogeny inside a loop, iterate over a copy instead (e.g. `for tax in list(sys.get_active_taxa()):`).
+        )mydelimiter")
+        .def("__len__", &taxa_view::GetSize)
+        .def("__bool__", [](const taxa_view & self){return self.GetSize() > 0;})
+        .def("__contains__", [](const taxa_view & self, const py::object & obj){
+            // Like other Python containers, anything that isn't a taxon just isn't in the view
+            return py::isinstance<taxon_t>(obj) && self.Has(obj.cast<taxon_t *>());
+        })
+        .def("__iter__", &taxa_view::Iterate, py::keep_alive<0, 1>())
+        .def("get_by_id", &taxa_view::FindID, py::arg("id"), py::return_value_policy::reference_internal, R"mydelimiter(
+            Returns the taxon in this set with the given ID, or None if there is no such taxon.
+            The search happens in C++, so only the matching taxon is converted to a Python object.
+
+            Parameters
+            ----------
+            id : int
+                ID of the taxon to look for.
+        )mydelimiter")
+        .def("get_page", &taxa_view::GetPage, py::arg("start"), py::arg("count"), py::return_value_policy::reference_internal, R"mydelimiter(
+            Returns a list of up to `count` taxa, skipping the first `start` taxa in iteration order.
+            Iteration order is arbitrary but stable as long as no taxa are created or removed.
+            The view remembers where the previous page ended, so reading consecutive pages from the same view (`get_page(0, n)`, `get_page(n, n)`, ...) takes time proportional to the page size rather than to `start`.
+
+            Parameters
+            ----------
+            start : int
+                Number of taxa to skip.
+            count : int
+                Maximum number of taxa to return.
+        )mydelimiter")
+        .def("to_set", &taxa_view::GetSet, py::return_value_policy::reference_internal, R"mydelimiter(
+            Returns a Python set containing every taxon in this view.
+            This converts the whole set to Python objects and should be avoided for large phylogenies.
+        )mydelimiter");
+
+    py::class_<snapshot_future>(m, "SnapshotFuture", R"mydelimiter(
+            Handle to a snapshot that is being written to disk on a background thread. Returned by `Systematics.snapshot_async()`.
+        )mydelimiter")
+        .def("done", &snapshot_future::Done, R"mydelimiter(
+            Returns whether the snapshot has finished being written (successfully or not).
+        )mydelimiter")
+        .def("wait", &snapshot_future::Wait, py::arg("timeout") = py::none(), R"mydelimiter(
+            Blocks until the snapshot has been written or the timeout expires. Returns whether the snapshot is done.
+
+            Parameters
+            ----------
+            timeout : float, optional
+                Maximum number of seconds to wait. Waits indefinitely if not specified.
+        )mydelimiter")
+        .def("result", &snapshot_future::Result, R"mydelimiter(
+            Blocks until the snapshot has been written. Raises an exception if writing the snapshot failed.
+        )mydelimiter");
+
     py::class_<sys_t>(m, "Systematics")
         .def(py::init<std::function<taxon_info_t(org_t &)>, bool, bool, bool, bool>(), py::arg("calc_taxon") = py::eval("lambda x: x"), py::arg("store_active") = true, py::arg("store_ancestors") = true, py::arg("store_all") = false, py::arg("store_pos") = false, R"mydelimiter(
             Construct a systematics manager to keep track of a phylogeny.
@@ -320,6 +1456,8 @@ PYBIND11_MODULE(systematics, m) {
             ----------
             val : bool
                 Value representing whether to store all dead taxa whose descendats have also died.
+
+            Raises a RuntimeError if unifurcations are being collapsed eagerly.
         )mydelimiter")
         .def("set_store_archive", static_cast<void (sys_t::*) (bool)>(&sys_t::SetArchive), R"mydelimiter(
             A setter method to configure whether to store taxa types that have become extinct.
@@ -346,23 +1484,39 @@ PYBIND11_MODULE(systematics, m) {
             A setter method to configure whether a synchronous population is being tracked. A synchronous population is one where parents must be extanct for their offspring to be born. As such, there are effectively two populations: a currently-active one, and one being created. This is in opposition to steady-state populations, where organisms might die as their offspring are born (for example, in a world where offspring replaces the parent).
             The accuracy of the systematics tracking relies on this option, so it is imperative it be configured properly.
             This option defaults to False.
+            Raises a RuntimeError if multiple populations are being tracked with `set_track_populations()`.
 
             Parameters
             ----------
             val : bool 
                 Value representing whether a synchronous population is being tracked.
         )mydelimiter")
-        .def("set_collapse_unifurcations", static_cast<void (sys_t::*) (bool)>(&sys_t::SetCollapseUnifurcations), R"mydelimiter(
+        .def("set_track_populations", &sys_t::SetTrackPopulations, R"mydelimiter(
+            A setter method to configure whether to track multiple separate populations (e.g. islands) by position.
+            When this is on, the population ID of each `WorldPosition` passed to the position-based methods identifies a separate population, and the systematics manager incrementally keeps track of which taxa are present in each one. This makes it possible to pass a population ID to `get_total_orgs()`, `get_num_active()`, `get_active_taxa()`, `calc_diversity()` and `get_mrca()`.
+            This must be configured before any organisms are added, and cannot be combined with `set_track_synchronous()`.
+            This option defaults to False.
+
+            Parameters
+            ----------
+            val : bool
+                Value representing whether to track multiple populations.
+        )mydelimiter")
+        .def("set_collapse_unifurcations", &sys_t::SetCollapseUnifurcations, py::arg("val"), py::arg("lazy") = false, R"mydelimiter(
             A setter method to configure whether unifurcations (sequences of extinct parents with exactly one offspring taxon)
             should be collapsed (i.e. extinct taxon with one offspring will be removed and the offspring's parent will be set to be 
             what was formerly its grandparent). This setting will save space and be more consistent with a lot of biological representations
             but will sacrifice information.
             This option defaults to False.
+            By default each unifurcation is collapsed as soon as it appears. With `lazy=True`, unifurcations are only marked as they appear, and every chain of them is spliced out at the next call to `update()`; depths are then recomputed once for each subtree that moved. After `update()` the tree, its statistics and its snapshots are the same as with eager collapse. This is much cheaper in long runs, but until `update()` is called the tree (and statistics such as `get_num_ancestors()`) still includes the unifurcations.
+            Eager collapsing deletes ancestors that outside taxa may still point to, so it raises a RuntimeError when outside taxa are being stored (e.g. `store_all=True`). Lazy collapsing re-parents those outside taxa and can be combined with storing them.
 
             Parameters
             ----------
             val : bool 
                 Value representing whether to collapse unifurcations
+            lazy : bool
+                Whether to defer collapsing to `update()`
         )mydelimiter")        
         .def("set_update", static_cast<void (sys_t::*) (size_t)>(&sys_t::SetUpdate), R"mydelimiter(
             A setter method to modify the current time step. This should be used if you want PhylotrackPy to track when events occur.
@@ -400,10 +1554,22 @@ PYBIND11_MODULE(systematics, m) {
             It is recommended to verify this setting before any tracking.
             Can be set using the `set_track_synchronous()` method.
         )mydelimiter")
+        .def("get_track_populations", &sys_t::GetTrackPopulations, R"mydelimiter(
+            Whether the Systematics Manager is configured to track multiple separate populations.
+            Can be set using the `set_track_populations()` method.
+        )mydelimiter")
+        .def("get_num_pops", &sys_t::GetNumPops, R"mydelimiter(
+            Returns the number of populations that have been tracked (i.e. one more than the highest population ID used).
+            This is always 0 unless `set_track_populations()` has been turned on.
+        )mydelimiter")
         .def("get_collapse_unifurcations", static_cast<bool (sys_t::*) () const>(&sys_t::GetCollapseUnifurcations), R"mydelimiter(
-            Whether the Systematics Manager is configured to collapse unifurcations.
+            Whether the Systematics Manager is configured to collapse unifurcations, either eagerly or lazily.
             Can be set using the `set_collapse_unifurcations()` method.
         )mydelimiter")
+        .def("get_lazy_collapse", &sys_t::GetLazyCollapse, R"mydelimiter(
+            Whether unifurcations are collapsed lazily, at each call to `update()`.
+            Can be set using the `lazy` argument of the `set_collapse_unifurcations()` method.
+        )mydelimiter")
         .def("get_update", static_cast<size_t (sys_t::*) () const>(&sys_t::GetUpdate), R"mydelimiter(
             Returns the current timestep of the simulation.
             This time step can be overriden using the `set_update()` method.
@@ -411,9 +1577,17 @@ PYBIND11_MODULE(systematics, m) {
         .def("get_total_orgs", static_cast<size_t (sys_t::*) () const>(&sys_t::GetTotalOrgs), R"mydelimiter(
             Returns the number of living organisms currently present in the population.
         )mydelimiter")
+        .def("get_total_orgs", &sys_t::GetPopTotalOrgs, py::arg("pop_id"), R"mydelimiter(
+            Returns the number of living organisms currently present in the population with the given ID.
+            Requires `set_track_populations()` to be on; raises a RuntimeError otherwise.
+        )mydelimiter")
         .def("get_num_active", static_cast<size_t (sys_t::*) () const>(&sys_t::GetNumActive), R"mydelimiter(
             Returns the number of active taxa in the population.
         )mydelimiter")
+        .def("get_num_active", &sys_t::GetPopNumActive, py::arg("pop_id"), R"mydelimiter(
+            Returns the number of taxa with living organisms in the population with the given ID.
+            Requires `set_track_populations()` to be on; raises a RuntimeError otherwise.
+        )mydelimiter")
         .def("get_num_ancestors", static_cast<size_t (sys_t::*) () const>(&sys_t::GetNumAncestors), R"mydelimiter(
             Returns the number of *extinct* taxa that are ancestors of living organisms currently present in the population.
         )mydelimiter")
@@ -443,16 +1617,65 @@ PYBIND11_MODULE(systematics, m) {
         .def("get_active_taxa_reference", static_cast<std::unordered_set< emp::Ptr<taxon_t>, emp::Ptr<taxon_t>::hash_t > * (sys_t::*) ()>(&sys_t::GetActivePtr), py::return_value_policy::reference_internal, R"mydelimiter(
             Returns a reference to the set of extant taxa.
         )mydelimiter")
-        .def("get_active_taxa", static_cast<const std::unordered_set< emp::Ptr<taxon_t>, emp::Ptr<taxon_t>::hash_t > & (sys_t::*) () const>(&sys_t::GetActive), py::return_value_policy::reference_internal, R"mydelimiter(
-            Returns a reference to the set of extant taxa.
+        .def("get_active_taxa", [](const sys_t & self){return taxa_view(self.GetActive(), self.GetTaxaVersion());}, py::keep_alive<0, 1>(), R"mydelimiter(
+            Returns a view of the set of extant taxa.
+            The view supports `len()`, iteration, and membership checks without converting the whole set to Python objects. Call `to_set()` on it if you need a Python set.
+            Changing the phylogeny while looping over the view raises a RuntimeError; earlier versions returned a copy of the set, so loops like `for tax in sys.get_active_taxa(): sys.remove_org(tax)` must now iterate over `list(sys.get_active_taxa())` instead.
+        )mydelimiter")
+        .def("get_active_taxa", &sys_t::GetPopActive, py::arg("pop_id"), py::keep_alive<0, 1>(), R"mydelimiter(
+            Returns a view of the set of taxa with living organisms in the population with the given ID.
+            This is the same kind of view returned by `get_active_taxa()` without arguments.
+            For a population ID that hasn't been used yet, the view is empty and stays empty; call this method again once organisms have been added to that population.
+            Requires `set_track_populations()` to be on; raises a RuntimeError otherwise.
         )mydelimiter")
-        .def("get_ancestor_taxa", static_cast<const std::unordered_set< emp::Ptr<taxon_t>, emp::Ptr<taxon_t>::hash_t > & (sys_t::*) () const>(&sys_t::GetAncestors), py::return_value_policy::reference_internal, R"mydelimiter(
-            Returns a reference to the set of ancestor taxa.
+        .def("get_ancestor_taxa", [](const sys_t & self){return taxa_view(self.GetAncestors(), self.GetTaxaVersion());}, py::keep_alive<0, 1>(), R"mydelimiter(
+            Returns a view of the set of ancestor taxa.
             These are extinct taxa with extant descendants.
+            The view supports `len()`, iteration, and membership checks without converting the whole set to Python objects. Call `to_set()` on it if you need a Python set.
+            Earlier versions returned a copy of the set. Removing organisms while looping over the view raises a RuntimeError, since the ancestors change as lineages die out; loop over `list(sys.get_ancestor_taxa())` instead.
         )mydelimiter")
-        .def("get_outside_taxa", static_cast<const std::unordered_set< emp::Ptr<taxon_t>, emp::Ptr<taxon_t>::hash_t > & (sys_t::*) () const>(&sys_t::GetOutside), py::return_value_policy::reference_internal, R"mydelimiter(
-            Returns a reference to the set of outside taxa.
+        .def("get_outside_taxa", [](const sys_t & self){return taxa_view(self.GetOutside(), self.GetTaxaVersion());}, py::keep_alive<0, 1>(), R"mydelimiter(
+            Returns a view of the set of outside taxa.
             These are extinct taxa with extinct descendants.
+            The view supports `len()`, iteration, and membership checks without converting the whole set to Python objects. Call `to_set()` on it if you need a Python set.
+            Earlier versions returned a copy of the set. Calling `remove_before()` or removing organisms while looping over the view raises a RuntimeError, since either can add or delete outside taxa; loop over `list(sys.get_outside_taxa())` instead.
+        )mydelimiter")
+        .def("find_taxa", [](const sys_t & self, const std::string & taxa, size_t min_num_orgs, std::optional<size_t> max_num_orgs, std::optional<double> origin_after, std::optional<double> origin_before, std::optional<size_t> limit){
+            const taxon_filter filter{min_num_orgs, max_num_orgs, origin_after, origin_before};
+            std::vector<taxon_ptr> found;
+            for (const taxon_set_t * tax_set : select_taxa(self, taxa)) {
+                for (taxon_ptr tax : *tax_set) {
+                    if (limit && found.size() >= *limit) return found;
+                    if (filter(tax)) found.push_back(tax);
+                }
+            }
+            return found;
+        },
+        py::arg("taxa") = "active",
+        py::arg("min_num_orgs") = 0,
+        py::arg("max_num_orgs") = py::none(),
+        py::arg("origin_after") = py::none(),
+        py::arg("origin_before") = py::none(),
+        py::arg("limit") = py::none(),
+        py::return_value_policy::reference_internal,
+        R"mydelimiter(
+            Returns a list of the taxa that match all of the given criteria.
+            Filtering happens in C++, so only the matching taxa are converted to Python objects.
+
+            Parameters
+            ----------
+            taxa : str
+                Which taxa to search: "active", "ancestors", "outside", or "all". Defaults to "active".
+            min_num_orgs : int
+                Only return taxa with at least this many living organisms.
+            max_num_orgs : int, optional
+                Only return taxa with at most this many living organisms.
+            origin_after : float, optional
+                Only return taxa that originated strictly after this time.
+            origin_before : float, optional
+                Only return taxa that originated strictly before this time.
+            limit : int, optional
+                Stop after finding this many taxa.
         )mydelimiter")
         .def("get_next_parent", static_cast<emp::Ptr<taxon_t> (sys_t::*) () const>(&sys_t::GetNextParent), py::return_value_policy::reference_internal, R"mydelimiter(
             Returns the taxon that corresponds to the parent of the next taxon. This will only be set if parents are being specified through calls to `set_next_parent()`.
@@ -487,6 +1710,10 @@ PYBIND11_MODULE(systematics, m) {
         .def("get_mrca", static_cast<emp::Ptr<taxon_t> (sys_t::*) () const>(&sys_t::GetMRCA), py::return_value_policy::reference_internal, R"mydelimiter(
             Returns a temporary, non-owning object (reference) representing the Most-Recent Common Ancestor of the population.
         )mydelimiter")
+        .def("get_mrca", &sys_t::GetPopMRCA, py::arg("pop_id"), py::return_value_policy::reference_internal, R"mydelimiter(
+            Returns a temporary, non-owning object (reference) representing the Most-Recent Common Ancestor of the organisms in the population with the given ID, or None if they do not share one.
+            Requires `set_track_populations()` to be on; raises a RuntimeError otherwise.
+        )mydelimiter")
         .def("get_shared_ancestor", [](sys_t & self, taxon_t * t1, taxon_t * t2){return self.GetSharedAncestor(t1, t2);}, py::return_value_policy::reference_internal, R"mydelimiter(
             Returns a temporary, non-owning object (reference) representing the Most-Recent Common Ancestor shared by two given taxa.
             The order of the taxa does not matter.
@@ -614,6 +1841,10 @@ PYBIND11_MODULE(systematics, m) {
         .def("calc_diversity", static_cast<double (sys_t::*) () const>(&sys_t::CalcDiversity), R"mydelimiter(
             Calculates and returns the Shannon Diversity Index of the current extant population. This is done by weighing each active taxon by the number of organisms in it.
         )mydelimiter")
+        .def("calc_diversity", &sys_t::CalcPopDiversity, py::arg("pop_id"), R"mydelimiter(
+            Calculates and returns the Shannon Diversity Index of the population with the given ID. This is done by weighing each taxon present by the number of its organisms in that population.
+            Requires `set_track_populations()` to be on; raises a RuntimeError otherwise.
+        )mydelimiter")
         .def("mrca_depth", static_cast<int (sys_t::*) () const>(&sys_t::GetMRCADepth), R"mydelimiter(
             This function returns the depth of the Most-Recent Common Ancestor for the active population -- that is, this returns the distance between the latest (i.e., newest) generation and the newest taxon that is an ancestor of the active taxa on the latest generation.
             If no MRCA exists, this returns -1.
@@ -644,6 +1875,48 @@ PYBIND11_MODULE(systematics, m) {
             tax : Taxon
                 Taxon to find distance to MRCA (or subroot) of.
         )mydelimiter")
+        .def("get_lineages", [](const sys_t & self){
+            return get_lineages(std::vector<taxon_ptr>(self.GetActive().begin(), self.GetActive().end()));
+        }, R"mydelimiter(
+            Returns the lineages of all active taxa. See the overload taking a list of taxa for details of the return value.
+        )mydelimiter")
+        .def("get_lineages", [](const sys_t & self, const std::vector<taxon_t *> & taxa){
+            return get_lineages(std::vector<taxon_ptr>(taxa.begin(), taxa.end()));
+        }, py::arg("taxa"), R"mydelimiter(
+            Returns the lineages of many taxa at once as a pair of NumPy arrays `(offsets, ids)`.
+            The lineage of the i-th taxon is `ids[offsets[i]:offsets[i+1]]`: the ID of the taxon itself, followed by the IDs of each of its ancestors back to its root.
+
+            This is much faster than calling `get_parent()` repeatedly from Python. Ancestors shared between lineages are only walked once, but they are still copied into every lineage that contains them, so the arrays hold the sum of the lineage lengths. For many deep lineages (e.g. every extant taxon of a long run) use `get_lineage_tree()` instead, whose size is the number of distinct taxa.
+
+            Parameters
+            ----------
+            taxa : List[Taxon] or List[int]
+                Taxa (or IDs of tracked taxa) to return the lineages of. If omitted, the lineages of all active taxa are returned.
+        )mydelimiter")
+        .def("get_lineages", [](const sys_t & self, const std::vector<size_t> & ids){
+            return get_lineages(find_taxa_by_id(self, ids));
+        }, py::arg("taxa"))
+        .def("get_lineage_tree", [](const sys_t & self){
+            return get_lineage_tree(std::vector<taxon_ptr>(self.GetActive().begin(), self.GetActive().end()));
+        }, R"mydelimiter(
+            Returns the union of the lineages of all active taxa. See the overload taking a list of taxa for details of the return value.
+        )mydelimiter")
+        .def("get_lineage_tree", [](const sys_t & self, const std::vector<taxon_t *> & taxa){
+            return get_lineage_tree(std::vector<taxon_ptr>(taxa.begin(), taxa.end()));
+        }, py::arg("taxa"), R"mydelimiter(
+            Returns the union of the lineages of many taxa at once as three NumPy arrays `(ids, parents, index)`.
+            `ids` holds the ID of every taxon in any of the lineages exactly once. `parents[k]` is the position in `ids` of the parent of `ids[k]`, or -1 for a root. `index[i]` is the position in `ids` of the i-th taxon passed in, so its lineage is found by following `parents` from there.
+
+            Unlike `get_lineages()`, shared ancestors are stored once, so both the time taken and the size of the result grow with the number of distinct taxa rather than the sum of the lineage lengths.
+
+            Parameters
+            ----------
+            taxa : List[Taxon] or List[int]
+                Taxa (or IDs of tracked taxa) to return the lineages of. If omitted, the lineages of all active taxa are returned.
+        )mydelimiter")
+        .def("get_lineage_tree", [](const sys_t & self, const std::vector<size_t> & ids){
+            return get_lineage_tree(find_taxa_by_id(self, ids));
+        }, py::arg("taxa"))
         .def("get_pairwise_distance", [](sys_t & self, taxon_t * tax, taxon_t * tax2, bool branch_only){return self.GetPairwiseDistance(tax, tax2, branch_only);}, 
         py::arg("tax"),
         py::arg("tax2"),
@@ -785,6 +2058,18 @@ PYBIND11_MODULE(systematics, m) {
             file_path : string
                 File path to save snapshot to.
         )mydelimiter")
+        .def("snapshot_async", &sys_t::SnapshotAsync, py::arg("file_path"), R"mydelimiter(
+            This method works like `snapshot()`, but writes the file on a background thread so that the simulation can continue while it is being saved. It returns a `SnapshotFuture` that can be used to wait for the file to be finished.
+
+            The state of the phylogeny is copied before this method returns, so adding and removing organisms afterwards does not affect the file. Custom snapshot functions added with `add_snapshot_fun()` are also evaluated before this method returns; only formatting and writing the file happen in the background.
+
+            You don't need to keep the returned `SnapshotFuture` around: if it is discarded, the file is still written in the background, and the interpreter waits for any unfinished snapshots before it exits. Errors are only reported through `SnapshotFuture.result()`, though. A process that ends without a normal interpreter shutdown (e.g. `os._exit()` or a fatal signal) can still leave a truncated file, so wait on the future if the file must be complete.
+
+            Parameters
+            ----------
+            file_path : string
+                File path to save snapshot to.
+        )mydelimiter")
         .def(
             "add_snapshot_fun",
             static_cast<void (sys_t::*)(
@@ -809,6 +2094,54 @@ PYBIND11_MODULE(systematics, m) {
             desc : str
                 Optional description for the custom information.
         )mydelimiter")
+        .def("add_data_column", &sys_t::AddDataColumn, py::arg("key"), py::arg("dtype") = "float64", py::arg("default") = 0, py::arg("desc") = "", R"mydelimiter(
+            This method adds a typed column of custom per-taxon data (for example, fitness or a phenotype measurement). Values are stored in C++, can be set and read in bulk with `set_data()` and `get_data()`, and are written by `snapshot()` under `key` without calling back into Python. Floating point values are written with enough digits to be read back exactly.
+
+            Only taxa that have been given a value take up memory, and a taxon's values are discarded when the taxon is deleted (when it is pruned and outside taxa aren't stored, removed by `remove_before()`, or collapsed as a unifurcation; values of taxa removed by eager collapse are discarded in batches as new taxa are created). `load_from_file()` clears every column. Values can only be set or read for taxa that are currently stored; other IDs raise a KeyError. Taxa that have not been given a value read as `default`.
+
+            Parameters
+            ----------
+            key : str
+                Name of the column. This is also the column name used in snapshot files.
+            dtype : str
+                Type of the values stored: either "float64" or "int64". Defaults to "float64".
+            default : float or int
+                Value of taxa that have not been given a value. Defaults to 0.
+            desc : str
+                Optional description for the custom information.
+        )mydelimiter")
+        .def("set_data", [](sys_t & self, const std::string & key, const std::vector<taxon_t *> & taxa, const py::object & values){
+            sys_t::ids_t ids(taxa.size());
+            std::transform(taxa.begin(), taxa.end(), ids.mutable_data(), [](taxon_t * tax){ return tax->GetID(); });
+            self.SetData(key, ids, values);
+        }, py::arg("key"), py::arg("taxa"), py::arg("values"), R"mydelimiter(
+            Sets the values of a data column added with `add_data_column()` for many taxa at once.
+
+            Parameters
+            ----------
+            key : str
+                Name of the column to set values in.
+            taxa : List[Taxon] or array of int
+                Taxa (or taxon IDs) to set the values of.
+            values : array of float or int
+                New values, one per taxon. Values are converted to the type of the column.
+        )mydelimiter")
+        .def("set_data", &sys_t::SetData, py::arg("key"), py::arg("taxa"), py::arg("values"))
+        .def("get_data", [](const sys_t & self, const std::string & key, const std::vector<taxon_t *> & taxa){
+            sys_t::ids_t ids(taxa.size());
+            std::transform(taxa.begin(), taxa.end(), ids.mutable_data(), [](taxon_t * tax){ return tax->GetID(); });
+            return self.GetData(key, ids);
+        }, py::arg("key"), py::arg("taxa"), R"mydelimiter(
+            Returns a NumPy array holding the values of a data column added with `add_data_column()` for the given taxa.
+
+            Parameters
+            ----------
+            key : str
+                Name of the column to read values from.
+            taxa : List[Taxon] or array of int
+                Taxa (or taxon IDs) to get the values of.
+        )mydelimiter")
+        .def("get_data", &sys_t::GetData, py::arg("key"), py::arg("taxa"))
         .def("print_status", [](sys_t & self){self.PrintStatus();}, R"mydelimiter(
             This method prints details about the systematics manager.
             It first prints all settings. Then, it prints all stored active, ancestor, and outside taxa in that order.
@@ -830,12 +2163,27 @@ PYBIND11_MODULE(systematics, m) {
         
         // Efficiency functions
         .def("remove_before", static_cast<void (sys_t::*) (int)>(&sys_t::RemoveBefore), R"mydelimiter(
-            This method removes all taxa that went extinct before the given time step, and that only have ancestors taht went extinct before the given time step. While this invalidates most tree topology metrics, it is useful when limited ancestry tracking is necessary, but complete ancestry tracking is not computationally possible.
+            This method removes all taxa that went extinct before the given time step, and that only have ancestors that went extinct before the given time step. While this invalidates most tree topology metrics, it is useful when limited ancestry tracking is necessary, but complete ancestry tracking is not computationally possible.
+
+            Outside taxa are indexed by the earliest time step at which they could be removed, so this method skips taxa that can't be removed yet instead of checking the ancestry of every stored taxon on each call.
 
             Parameters
             ----------
             ud : int
                 Time step before which to remove taxa.
         )mydelimiter")
+        .def("set_remove_before_window", &sys_t::SetRemoveBeforeWindow, py::arg("window"), R"mydelimiter(
+            Automatically call `remove_before()` whenever the time step changes (through `update()` or `set_update()`), removing outside taxa that went extinct more than `window` time steps ago. This keeps memory use bounded when storing outside taxa in long runs.
+            Pass None to turn this off. This option defaults to None.
+
+            Parameters
+            ----------
+            window : int or None
+                Number of time steps to keep outside taxa for after they go extinct.
+        )mydelimiter")
+        .def("get_remove_before_window", &sys_t::GetRemoveBeforeWindow, R"mydelimiter(
+            Returns the number of time steps outside taxa are kept for after going extinct, or None if they are kept forever.
+            Can be set using the `set_remove_before_window()` method.
+        )mydelimiter")
         ;
 }
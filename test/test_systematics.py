@@ -1,10 +1,15 @@
 #!/usr/bin/env python3
+import csv
 import os
+import random
+import subprocess
+import sys as python_sys
 from phylotrackpy import systematics
 import pytest
 from pytest import approx, mark, raises
 from copy import deepcopy
 import tempfile
+import time
  
 assets_path = os.path.join(
     os.path.dirname(os.path.abspath(__file__)), 
@@ -287,6 +292,139 @@ def test_raw_taxa_serialization(orgs):
     assert sys.get_mrca().get_info() == org_info_1
 
 
+def test_snapshot_async():
+    sys = systematics.Systematics(lambda x: x, True, True, True, False)
+    sys.set_update(0)
+    tax1 = sys.add_org(1)
+    sys.set_update(3)
+    tax2 = sys.add_org(2, tax1)
+    tax3 = sys.add_org(3, tax2)
+    sys.remove_org(tax1)
+    sys.remove_org(tax3)
+    sys.add_snapshot_fun(systematics.encode_taxon, "info")
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        sync_path = os.path.join(tmp_dir, "sync.csv")
+        async_path = os.path.join(tmp_dir, "async.csv")
+        sys.snapshot(sync_path)
+        future = sys.snapshot_async(async_path)
+        # Changes made after the call must not show up in the file
+        sys.add_org(4, tax2)
+        assert future.wait(timeout=60)
+        assert future.done()
+        future.result()
+
+        with open(sync_path) as sync_file, open(async_path) as async_file:
+            sync_rows = list(csv.DictReader(sync_file))
+            async_rows = list(csv.DictReader(async_file))
+        assert async_rows == sync_rows
+
+        loaded = systematics.Systematics(lambda x: x)
+        loaded.load_from_file(async_path, "info")
+        assert loaded.get_num_taxa() == 3
+
+        bad_future = sys.snapshot_async(os.path.join(tmp_dir, "missing", "dir.csv"))
+        with raises(RuntimeError):
+            bad_future.result()
+
+        # Dropping the handle must neither block nor stop the write
+        dropped_path = os.path.join(tmp_dir, "dropped.csv")
+        sys.snapshot_async(dropped_path)
+        contents = ""
+        for _ in range(600):
+            if os.path.exists(dropped_path):
+                with open(dropped_path) as dropped_file:
+                    contents = dropped_file.read()
+                if contents.count("\n") == len(sync_rows) + 2:
+                    break
+            time.sleep(0.1)
+        assert len(list(csv.DictReader(contents.splitlines()))) == len(sync_rows) + 1
+
+        # The interpreter waits for unfinished snapshots before exiting
+        exit_path = os.path.join(tmp_dir, "exit.csv")
+        script = (
+            "from phylotrackpy import systematics\n"
+            "sys = systematics.Systematics(lambda x: x)\n"
+            "taxa = [sys.add_org(0)]\n"
+            "for i in range(1, 20000):\n"
+            "    taxa.append(sys.add_org(i, taxa[-1]))\n"
+            f"sys.snapshot_async({exit_path!r})\n"
+        )
+        subprocess.run([python_sys.executable, "-c", script], check=True)
+        with open(exit_path) as exit_file:
+            assert len(list(csv.DictReader(exit_file))) == 20000
+
+
+def test_data_columns():
+    import numpy as np
+    sys = systematics.Systematics(lambda x: x, True, True, False, False)
+    tax1 = sys.add_org(1)
+    tax2 = sys.add_org(2, tax1)
+    tax3 = sys.add_org(3, tax2)
+
+    sys.add_data_column("fitness")
+    sys.add_data_column("phenotype", "int64", default=-1)
+    with raises(ValueError):
+        sys.add_data_column("fitness")
+    with raises(ValueError):
+        sys.add_data_column("bad", "str")
+
+    sys.set_data("fitness", [tax1, tax3], [0.5, 2.25])
+    sys.set_data("phenotype", np.array([tax2.get_id()]), np.array([7]))
+    assert list(sys.get_data("fitness", [tax1, tax2, tax3])) == [0.5, 0, 2.25]
+    phenotypes = sys.get_data("phenotype", [tax1.get_id(), tax2.get_id()])
+    assert phenotypes.dtype == np.int64
+    assert list(phenotypes) == [-1, 7]
+    with raises(KeyError):
+        sys.get_data("missing", [tax1])
+    with raises(ValueError):
+        sys.set_data("fitness", [tax1, tax2], [1.0])
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        path = os.path.join(tmp_dir, "data.csv")
+        sys.snapshot(path)
+        with open(path) as f:
+            rows = {int(row["id"]): row for row in csv.DictReader(f)}
+    assert float(rows[tax3.get_id()]["fitness"]) == 2.25
+    assert float(rows[tax2.get_id()]["fitness"]) == 0
+    assert int(rows[tax2.get_id()]["phenotype"]) == 7
+    assert int(rows[tax1.get_id()]["phenotype"]) == -1
+
+    # Floats must survive a snapshot exactly, not rounded to 6 digits
+    sys.set_data("fitness", [tax1, tax2], [0.123456789, 1234567.5])
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        path = os.path.join(tmp_dir, "data.csv")
+        sys.snapshot(path)
+        with open(path) as f:
+            rows = {int(row["id"]): row for row in csv.DictReader(f)}
+    assert float(rows[tax1.get_id()]["fitness"]) == 0.123456789
+    assert float(rows[tax2.get_id()]["fitness"]) == 1234567.5
+
+    with raises(KeyError):
+        sys.set_data("fitness", np.array([-1]), np.array([1.0]))
+    with raises(KeyError):
+        sys.get_data("fitness", np.array([sys.get_next_id()]))
+
+    # Values go away with their taxon, and deleted taxa can't be given new ones
+    tax4 = sys.add_org(4)
+    sys.set_data("fitness", [tax4], [3.0])
+    tax4_id = tax4.get_id()
+    sys.remove_org(tax4)
+    with raises(KeyError):
+        sys.get_data("fitness", np.array([tax4_id]))
+    with raises(KeyError):
+        sys.set_data("fitness", np.array([tax4_id]), [1.0])
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        path = os.path.join(tmp_dir, "data.csv")
+        sys.add_snapshot_fun(systematics.encode_taxon, "info")
+        sys.snapshot(path)
+        sys.load_from_file(path, "info")
+    loaded_ids = [tax.get_id() for tax in sys.get_active_taxa()]
+    assert loaded_ids
+    assert list(sys.get_data("fitness", np.array(loaded_ids))) == [0] * len(loaded_ids)
+
+
 def test_shared_ancestor():
     sys = systematics.Systematics(taxon_info_fun, True, True, False, False)
     org1 = ExampleOrg("hello")
@@ -405,6 +543,102 @@ def test_loading_stats():
     sys2.load_from_file(f"{assets_path}/full.csv", "id", True, False)
 
 
+def test_taxa_views():
+    sys = systematics.Systematics(lambda x: x, True, True, False, False)
+    sys.set_update(0)
+    tax1 = sys.add_org(1)
+    sys.set_update(5)
+    tax2 = sys.add_org(2, tax1)
+    tax3 = sys.add_org(3, tax1)
+    sys.add_org(3, tax3)
+    sys.remove_org(tax1)
+
+    active = sys.get_active_taxa()
+    assert len(active) == 2
+    assert tax2 in active
+    assert tax1 not in active
+    assert 5 not in active
+    assert None not in active
+    assert tax1 in sys.get_ancestor_taxa()
+    assert len(sys.get_outside_taxa()) == 0
+    assert not sys.get_outside_taxa()
+    assert {tax.get_id() for tax in active} == {tax2.get_id(), tax3.get_id()}
+    assert active.get_by_id(tax3.get_id()) == tax3
+    assert active.get_by_id(tax1.get_id()) is None
+    assert len(active.get_page(0, 1)) == 1
+    assert len(active.get_page(1, 5)) == 1
+    assert active.get_page(2, 5) == []
+    assert active.to_set() == {tax2, tax3}
+
+    with raises(RuntimeError):
+        for tax in sys.get_active_taxa():
+            sys.add_org(4, tax)
+
+    assert sys.find_taxa(min_num_orgs=2) == [tax3]
+    assert len(sys.find_taxa(origin_after=0)) == 3
+    assert sys.find_taxa("ancestors") == [tax1]
+    assert len(sys.find_taxa("all", origin_before=5)) == 1
+    assert len(sys.find_taxa("all", limit=2)) == 2
+    with raises(ValueError):
+        sys.find_taxa("everything")
+
+    # Replacing one taxon with another leaves the size unchanged, but still invalidates iteration
+    tax5 = sys.add_org(5)
+    with raises(RuntimeError):
+        for tax in sys.get_active_taxa():
+            sys.remove_org(tax5)
+            tax5 = sys.add_org(5)
+
+    for i in range(20):
+        sys.add_org(100 + i, tax2)
+    active = sys.get_active_taxa()
+    pages = [active.get_page(start, 3) for start in range(0, len(active), 3)]
+    assert {tax.get_id() for page in pages for tax in page} == {tax.get_id() for tax in active}
+    assert sum(len(page) for page in pages) == len(active)
+
+
+def test_get_lineages():
+    sys = systematics.Systematics(lambda x: x, True, True, False, False)
+    tax1 = sys.add_org(1)
+    tax2 = sys.add_org(2, tax1)
+    tax3 = sys.add_org(3, tax2)
+    tax4 = sys.add_org(4, tax2)
+    tax5 = sys.add_org(5)
+
+    offsets, ids = sys.get_lineages([tax3, tax4, tax5, tax2])
+    assert list(offsets) == [0, 3, 6, 7, 9]
+    assert list(ids[0:3]) == [tax3.get_id(), tax2.get_id(), tax1.get_id()]
+    assert list(ids[3:6]) == [tax4.get_id(), tax2.get_id(), tax1.get_id()]
+    assert list(ids[6:7]) == [tax5.get_id()]
+    assert list(ids[7:9]) == [tax2.get_id(), tax1.get_id()]
+
+    offsets2, ids2 = sys.get_lineages([tax3.get_id(), tax4.get_id(), tax5.get_id(), tax2.get_id()])
+    assert list(offsets2) == list(offsets)
+    assert list(ids2) == list(ids)
+
+    offsets, ids = sys.get_lineages()
+    assert len(offsets) == sys.get_num_active() + 1
+    assert len(ids) == 10
+
+    with raises(KeyError):
+        sys.get_lineages([1000])
+
+    ids, parents, index = sys.get_lineage_tree([tax3, tax4, tax5, tax2])
+    assert len(ids) == 5
+    for i, tax in enumerate([tax3, tax4, tax5, tax2]):
+        lineage = []
+        k = index[i]
+        while k != -1:
+            lineage.append(ids[k])
+            k = parents[k]
+        assert lineage == list(sys.get_lineages([tax])[1])
+
+    ids2, parents2, index2 = sys.get_lineage_tree([tax3.get_id(), tax4.get_id(), tax5.get_id(), tax2.get_id()])
+    assert list(ids2) == list(ids)
+    assert list(parents2) == list(parents)
+    assert list(index2) == list(index)
+
+
 def test_pairwise_hang():
     syst = systematics.Systematics(lambda x: x)
     syst.load_from_file(f"{assets_path}/hang_test.csv", "id", True)
@@ -474,6 +708,155 @@ def test_synchronous_by_position():
     assert sys.get_num_taxa() == 20
 
 
+def test_populations():
+    sys = systematics.Systematics(lambda x: x, True, True, False, True)
+    sys.set_track_populations(True)
+    assert sys.get_track_populations()
+
+    # Same index on different islands must not collide
+    sys.add_org_by_position("a", (0, 0))
+    sys.add_org_by_position("b", (0, 3))
+    assert sys.get_num_pops() == 4
+    assert sys.get_taxon_at((0, 0)).get_info() == "a"
+    assert sys.get_taxon_at((0, 3)).get_info() == "b"
+    assert not sys.is_taxon_at((0, 1))
+
+    sys.add_org_by_position("a", (1, 0), (0, 0))
+    sys.add_org_by_position("c", (2, 0), (0, 0))
+    sys.add_org_by_position("d", (1, 3), (0, 3))
+    assert sys.get_total_orgs() == 5
+    assert sys.get_total_orgs(0) == 3
+    assert sys.get_total_orgs(3) == 2
+    assert sys.get_total_orgs(1) == 0
+    assert sys.get_num_active(0) == 2
+    assert sys.get_num_active(3) == 2
+    assert {tax.get_info() for tax in sys.get_active_taxa(3)} == {"b", "d"}
+    assert type(sys.get_active_taxa(3)) is type(sys.get_active_taxa())
+    assert len(sys.get_active_taxa(3)) == 2
+    assert sys.calc_diversity(0) == approx(0.918296)
+    assert sys.calc_diversity(1) == 0
+    assert sys.get_mrca(0).get_info() == "a"
+    assert sys.get_mrca(3).get_info() == "b"
+    assert sys.get_mrca(1) is None
+
+    # Migrate "c" to island 3; islands 0 and 3 no longer share taxa
+    sys.swap_positions((2, 0), (2, 3))
+    assert sys.get_num_active(0) == 1
+    assert sys.get_total_orgs(3) == 3
+    assert sys.get_mrca(3) is None
+    assert sys.calc_diversity(0) == 0
+
+    sys.remove_org_by_position((0, 0))
+    assert sys.get_total_orgs(0) == 1
+    assert sys.get_total_orgs() == 4
+
+    sys.remove_org_by_position_after_repro((1, 0))
+    assert sys.is_taxon_at((1, 0))
+    sys.add_org_by_position("e", (3, 0), (1, 0))
+    assert not sys.is_taxon_at((1, 0))
+    assert sys.get_taxon_at((3, 0)).get_parent().get_info() == "a"
+    assert sys.get_total_orgs(0) == 1
+
+    sys.set_next_parent_by_position((3, 0))
+    sys.add_org_by_position("f", (4, 0))
+    assert sys.get_taxon_at((4, 0)).get_parent() == sys.get_taxon_at((3, 0))
+    assert sys.get_next_parent() is None
+
+    with raises(RuntimeError):
+        sys.set_track_populations(False)
+    with raises(RuntimeError):
+        sys.set_track_synchronous(True)
+
+    # Reading an unused population doesn't create it
+    num_pops = sys.get_num_pops()
+    assert len(sys.get_active_taxa(10**6)) == 0
+    assert sys.get_num_pops() == num_pops
+
+    sys2 = systematics.Systematics(lambda x: x)
+    sys2.add_org("a")
+    # Without population tracking there are no per-population answers to give
+    with raises(RuntimeError):
+        sys2.get_total_orgs(0)
+    with raises(RuntimeError):
+        sys2.get_num_active(0)
+    with raises(RuntimeError):
+        sys2.get_active_taxa(0)
+    with raises(RuntimeError):
+        sys2.calc_diversity(0)
+    with raises(RuntimeError):
+        sys2.get_mrca(0)
+
+    sys3 = systematics.Systematics(lambda x: x)
+    sys3.set_track_synchronous(True)
+    with raises(RuntimeError):
+        sys3.set_track_populations(True)
+
+
+def test_remove_before():
+    sys = systematics.Systematics(lambda x: x, True, True, True, False)
+    sys.set_update(0)
+    root = sys.add_org(0)
+    sys.set_update(1)
+    tax_a = sys.add_org(1, root)
+    tax_b = sys.add_org(2, tax_a)
+    sys.set_update(2)
+    sys.remove_org(tax_b)
+    sys.set_update(3)
+    tax_c = sys.add_org(3, root)
+    sys.remove_org(tax_a)
+    sys.set_update(6)
+    tax_d = sys.add_org(4, tax_c)
+    sys.remove_org(tax_d)
+    assert sys.get_num_outside() == 3
+
+    # Every outside taxon descends from the living root, so none can be removed
+    sys.remove_before(10)
+    assert sys.get_num_outside() == 3
+
+    sys.set_update(7)
+    sys.remove_org(root)
+    # a and b only have ancestors that went extinct before 8, but the root died at 7
+    sys.remove_before(7)
+    assert sys.get_num_outside() == 3
+    sys.remove_before(8)
+    assert sys.get_num_outside() == 1
+    assert {tax.get_id() for tax in sys.get_outside_taxa()} == {tax_d.get_id()}
+    assert sys.get_num_active() == 1
+
+    # Kept taxa whose parents are removed become roots
+    sys2 = systematics.Systematics(lambda x: x, True, True, True, False)
+    sys2.set_update(0)
+    tax_x = sys2.add_org(1)
+    sys2.set_update(1)
+    tax_y = sys2.add_org(2, tax_x)
+    sys2.set_update(2)
+    sys2.remove_org(tax_x)
+    sys2.set_update(7)
+    sys2.remove_org(tax_y)
+    assert sys2.get_num_outside() == 2
+    sys2.remove_before(5)
+    assert sys2.get_num_outside() == 1
+    assert tax_y.get_parent() is None
+
+    assert sys2.get_remove_before_window() is None
+    sys2.set_remove_before_window(2)
+    assert sys2.get_remove_before_window() == 2
+    sys2.set_update(9)
+    assert sys2.get_num_outside() == 1
+    sys2.update()
+    assert sys2.get_num_outside() == 0
+
+    # Collapsing eagerly would delete parents that outside taxa still point to
+    with raises(RuntimeError):
+        sys2.set_collapse_unifurcations(True)
+    sys2.set_collapse_unifurcations(True, lazy=True)
+    sys2.set_collapse_unifurcations(False)
+    sys3 = systematics.Systematics(lambda x: x)
+    sys3.set_collapse_unifurcations(True)
+    with raises(RuntimeError):
+        sys3.set_store_outside(True)
+
+
 def test_custom_class():
 
     syst = systematics.Systematics(lambda org: org.genotype)
@@ -508,6 +891,99 @@ def test_collapse_unifurcations():
     assert sys.get_num_ancestors() == 0
 
 
+def test_lazy_collapse_unifurcations():
+    sys = systematics.Systematics(lambda x: x, True, True, False, False)
+    sys.set_collapse_unifurcations(True, lazy=True)
+    assert sys.get_collapse_unifurcations() is True
+    assert sys.get_lazy_collapse() is True
+    tax1 = sys.add_org(1)
+    tax2 = sys.add_org(2, tax1)
+    tax3 = sys.add_org(3, tax2)
+    tax4 = sys.add_org(4, tax3)
+    sys.remove_org(tax2)
+    sys.remove_org(tax3)
+
+    # Nothing is collapsed until the next update
+    assert sys.get_num_ancestors() == 2
+    assert sys.get_max_depth() == 3
+    assert sys.get_ave_depth() == approx(1.5)
+    sys.update()
+    assert sys.get_num_ancestors() == 0
+    assert tax4.get_parent().get_id() == tax1.get_id()
+    assert sys.get_max_depth() == 1
+    assert sys.get_ave_depth() == approx(0.5)
+
+    # Outside taxa hanging off a collapsed taxon are moved to its ancestor
+    sys2 = systematics.Systematics(lambda x: x, True, True, True, False)
+    sys2.set_collapse_unifurcations(True, lazy=True)
+    tax1 = sys2.add_org(1)
+    tax2 = sys2.add_org(2, tax1)
+    tax3 = sys2.add_org(3, tax2)
+    tax4 = sys2.add_org(4, tax2)
+    sys2.remove_org(tax2)
+    sys2.remove_org(tax4)
+    sys2.update()
+    assert sys2.get_num_ancestors() == 0
+    assert sys2.get_num_outside() == 1
+    assert tax3.get_parent().get_id() == tax1.get_id()
+    assert tax4.get_parent().get_id() == tax1.get_id()
+
+    sys2.set_collapse_unifurcations(False)
+    assert sys2.get_collapse_unifurcations() is False
+    assert sys2.get_lazy_collapse() is False
+
+
+def collapse_run(lazy, tmp_dir):
+    """Runs a small neutral model and records the tree after every update."""
+    rng = random.Random(7)
+    sys = systematics.Systematics(lambda x: x, True, True, False, False)
+    sys.set_collapse_unifurcations(True, lazy=lazy)
+    next_genotype = 1
+    population = [sys.add_org(0) for _ in range(15)]
+    states = []
+    for generation in range(40):
+        children = []
+        for _ in range(len(population)):
+            parent = rng.choice(population)
+            genotype = parent.get_info()
+            if rng.random() < 0.3:
+                genotype = next_genotype
+                next_genotype += 1
+            children.append(sys.add_org(genotype, parent))
+        for tax in population:
+            sys.remove_org(tax)
+        population = children
+        sys.update()
+
+        path = os.path.join(tmp_dir, f"lazy={int(lazy)}+gen={generation}.csv")
+        sys.snapshot(path)
+        with open(path) as f:
+            rows = {row["id"]: row for row in csv.DictReader(f)}
+        mrca = sys.get_mrca()
+        states.append({
+            "mrca": mrca.get_id() if mrca else None,
+            "mrca depth": sys.mrca_depth(),
+            "max depth": sys.get_max_depth(),
+            "ave depth": sys.get_ave_depth(),
+            "ancestors": sys.get_num_ancestors(),
+            "roots": sys.get_num_roots(),
+            "rows": rows,
+        })
+    return states
+
+
+def test_lazy_collapse_matches_eager():
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        eager = collapse_run(False, tmp_dir)
+        lazy = collapse_run(True, tmp_dir)
+    assert any(state["rows"] for state in eager)
+    for eager_state, lazy_state in zip(eager, lazy):
+        assert lazy_state["ave depth"] == approx(eager_state.pop("ave depth"))
+        lazy_state.pop("ave depth")
+        # Every snapshot column, including ancestor_list, total_offspring and depth
+        assert lazy_state == eager_state
+
+
 tax_sum = 0
 
 